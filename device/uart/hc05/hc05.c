@@ -1,11 +1,49 @@
 #include "hc05.h"
+#include "ringbuf.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 #if defined(VOFA)
-const uint8_t tail[4] = {0x00, 0x00, 0x80, 0x7f};
+static const uint8_t tail[4] = {0x00, 0x00, 0x80, 0x7f};
 #endif
 
+// CRC-16/CCITT-FALSE(多项式0x1021)查表，每字节一次查表
+static const uint16_t crc16Table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
 /**
  * @brief 初始化HC05对象
  *
@@ -27,26 +65,105 @@ HC05ErrorType HC05O_bjectInit(HC05ObjectType *hc05, HC05_TxData tx,
   hc05->TxData = tx;
   hc05->RxData = rx;
 
+  /*默认不使用缓冲*/
+  hc05->txRing = NULL;
+  hc05->rxRing = NULL;
+
   return HC05_Ok;
 }
 
 /**
- * @brief 使用hc05发送出一包数据
+ * @brief 使用hc05发送出一包数据，整包组帧后一次发送
  *
  * @param hc05 hc05对象实体
- * @param txPacket 要发送的数据包
- * @return uint8_t
+ * @param txPacket 要发送的数据包，len不超过HC05_PACKET_MAX_PAYLOAD
+ * @return uint8_t 0为成功
+ * @note 帧格式 |head|id|len|payload|CRC16低字节|CRC16高字节|，CRC覆盖id、len与payload；
+ *       缓冲模式下整包写入发送缓冲，空间不足时整包丢弃并返回1
  */
 uint8_t HC05_TxPacket(HC05ObjectType *hc05, HC05Packet *txPacket) {
-  uint8_t status;
+  uint8_t frame[HC05_FRAME_MAX];
+  uint8_t size = 3 + txPacket->len;
+  uint16_t crc;
 
-  status += hc05->TxData(&txPacket->head, 1);
-  status += hc05->TxData(&txPacket->id, 1);
-  status += hc05->TxData(txPacket->pData, txPacket->len);
+  if (txPacket->len > HC05_PACKET_MAX_PAYLOAD ||
+      (txPacket->pData == NULL && txPacket->len != 0)) {
+    return 1;
+  }
+
+  /*组帧*/
+  frame[0] = txPacket->head;
+  frame[1] = txPacket->id;
+  frame[2] = txPacket->len;
+  if (txPacket->len != 0) {
+    memcpy(&frame[3], txPacket->pData, txPacket->len);
+  }
+  crc = HC05_CRC16(&frame[1], size - 1);
+  frame[size++] = (uint8_t)crc;
+  frame[size++] = (uint8_t)(crc >> 8);
 #if defined(VOFA)
-  status += hc05->TxData(tail, 4);
+  memcpy(&frame[size], tail, 4);
+  size += 4;
 #endif
-  return status;
+
+  if (hc05->txRing != NULL) {
+    if (RingBufFree(hc05->txRing) < size) {
+      return 1;
+    }
+    RingBufPush(hc05->txRing, frame, size);
+    return 0;
+  }
+
+  return hc05->TxData(frame, size);
+}
+
+/**
+ * @brief 校验并解析一帧数据
+ *
+ * @param frame 以包头开始的接收数据
+ * @param len 接收数据长度，不小于帧长即可
+ * @param packet 解析结果，pData指向frame内的载荷
+ * @return HC05ErrorType 长度不足或CRC错误时为HC05_DataError
+ * @note 不检查head的值，由调用者按约定的包头查找帧起点
+ */
+HC05ErrorType HC05_DecodePacket(const uint8_t *frame, uint16_t len,
+                                HC05Packet *packet) {
+  uint16_t size, crc;
+
+  if (len < HC05_PACKET_OVERHEAD) {
+    return HC05_DataError;
+  }
+  size = 3 + frame[2];
+  if (len < size + 2) {
+    return HC05_DataError;
+  }
+
+  crc = HC05_CRC16(&frame[1], size - 1);
+  if (frame[size] != (uint8_t)crc || frame[size + 1] != (uint8_t)(crc >> 8)) {
+    return HC05_DataError;
+  }
+
+  packet->head = frame[0];
+  packet->id = frame[1];
+  packet->len = frame[2];
+  packet->pData = (uint8_t *)&frame[3];
+  return HC05_Ok;
+}
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE(初值0xFFFF，不反转，无异或输出)
+ *
+ * @param data 数据
+ * @param len 字节数
+ * @return uint16_t CRC值
+ */
+uint16_t HC05_CRC16(const uint8_t *data, uint16_t len) {
+  uint16_t crc = 0xFFFF;
+
+  while (len--) {
+    crc = (uint16_t)((crc << 8) ^ crc16Table[(uint8_t)(crc >> 8) ^ *data++]);
+  }
+  return crc;
 }
 
 /**
@@ -56,9 +173,75 @@ uint8_t HC05_TxPacket(HC05ObjectType *hc05, HC05Packet *txPacket) {
  * @param rxData 存放接收数据的数组地址
  * @param len 要接收的数据长度
  * @return uint8_t
+ * @note 缓冲模式下不阻塞，缓冲中不足len字节时不取出并返回1
  */
 uint8_t HC05_RxPacket(HC05ObjectType *hc05, uint8_t *rxData, uint8_t len) {
-  uint8_t status;
+  uint8_t status = 0;
+
+  if (hc05->rxRing != NULL) {
+    if (RingBufUsed(hc05->rxRing) < len) {
+      return 1;
+    }
+    RingBufPop(hc05->rxRing, rxData, len);
+    return 0;
+  }
   status += hc05->RxData(rxData, len);
   return status;
 }
+
+/**
+ * @brief 设置缓冲模式
+ *
+ * @param hc05 hc05对象实体
+ * @param txRing 发送缓冲，NULL为直接发送
+ * @param rxRing 接收缓冲，NULL为直接接收
+ * @note 缓冲区需已由RingBuf_Init初始化
+ */
+void HC05_SetBuffers(HC05ObjectType *hc05, struct RingBuf *txRing,
+                     struct RingBuf *rxRing) {
+  hc05->txRing = txRing;
+  hc05->rxRing = rxRing;
+}
+
+/**
+ * @brief 将发送缓冲中的数据按连续段交给串口发送函数，在主循环中调用
+ *
+ * @param hc05 hc05对象实体
+ * @return uint8_t 串口发送函数返回值之和
+ * @note 每段发送返回后才释放缓冲；使用DMA时应直接用RingBufReadSpan/RingBufCommitRead，
+ *       在发送完成中断中释放
+ */
+uint8_t HC05_TxPump(HC05ObjectType *hc05) {
+  uint8_t status = 0;
+  uint8_t *span;
+  uint32_t len;
+
+  if (hc05->txRing == NULL) {
+    return 0;
+  }
+
+  while ((len = RingBufReadSpan(hc05->txRing, &span)) != 0) {
+    if (len > 255) {
+      len = 255;
+    }
+    status += hc05->TxData(span, (uint8_t)len);
+    RingBufCommitRead(hc05->txRing, len);
+  }
+  return status;
+}
+
+/**
+ * @brief 将串口收到的字节写入接收缓冲，在串口接收/IDLE中断中调用
+ *
+ * @param hc05 hc05对象实体
+ * @param bytes 收到的字节
+ * @param len 字节数
+ * @return uint16_t 实际写入的字节数，缓冲已满时多余字节丢弃
+ */
+uint16_t HC05_RxFeed(HC05ObjectType *hc05, const uint8_t *bytes,
+                     uint16_t len) {
+  if (hc05->rxRing == NULL) {
+    return 0;
+  }
+  return (uint16_t)RingBufPush(hc05->rxRing, bytes, len);
+}
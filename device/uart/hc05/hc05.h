@@ -18,8 +18,20 @@ typedef enum {
   HC05_Ok,
   HC05_InitError,
   HC05_Absent,
+  HC05_DataError,
 } HC05ErrorType;
 
+// 帧头、ID、长度与CRC16共5字节
+#define HC05_PACKET_OVERHEAD 5
+// 整帧(含VOFA帧尾)上限，TxData一次最多发送255字节
+#define HC05_FRAME_MAX 255
+// 单包最大载荷，VOFA模式下为帧尾留出4字节
+#if defined(VOFA)
+#define HC05_PACKET_MAX_PAYLOAD (HC05_FRAME_MAX - HC05_PACKET_OVERHEAD - 4)
+#else
+#define HC05_PACKET_MAX_PAYLOAD (HC05_FRAME_MAX - HC05_PACKET_OVERHEAD)
+#endif
+
 /*HC05数据包*/
 typedef struct {
   uint8_t head;   // 包头
@@ -28,8 +40,13 @@ typedef struct {
   uint8_t len;    // 数据长度
 } HC05Packet;
 
+struct RingBuf; // 环形缓冲区(modules/ringbuf)
+
 /*HC05对象类型*/
 typedef struct {
+  /*缓冲模式，为NULL时直接调用串口函数*/
+  struct RingBuf *txRing; // 发送缓冲，由HC05_TxPump发出
+  struct RingBuf *rxRing; // 接收缓冲，由串口中断调用HC05_RxFeed填入
   /*functions*/
   uint8_t (*TxData)(uint8_t *txBuf,
                     uint8_t len); // 绑定串口发送多个字节的函数到设备HC05
@@ -49,5 +66,13 @@ HC05ErrorType HC05O_bjectInit(HC05ObjectType *hc05, HC05_TxData tx,
                              HC05_RxData rx);
 uint8_t HC05_TxPacket(HC05ObjectType *hc05, HC05Packet *txPacket);
 uint8_t HC05_RxPacket(HC05ObjectType *hc05, uint8_t *rxData, uint8_t len);
+HC05ErrorType HC05_DecodePacket(const uint8_t *frame, uint16_t len,
+                                HC05Packet *packet);
+uint16_t HC05_CRC16(const uint8_t *data, uint16_t len);
+void HC05_SetBuffers(HC05ObjectType *hc05, struct RingBuf *txRing,
+                     struct RingBuf *rxRing);
+uint8_t HC05_TxPump(HC05ObjectType *hc05);
+uint16_t HC05_RxFeed(HC05ObjectType *hc05, const uint8_t *bytes,
+                     uint16_t len);
 
 #endif
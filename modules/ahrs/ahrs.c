@@ -0,0 +1,34 @@
+#include "ahrs.h"
+#include <stddef.h>
+
+/**
+ * @brief 绑定AHRS对象与解算后端
+ *
+ * @param ahrs AHRSObjectType
+ * @param backend 后端接口，如&AHRS_Mahony
+ * @param filter 与后端匹配且已初始化的滤波器实体
+ * @return AHRSErrorType
+ */
+AHRSErrorType AHRS_ObjectInit(AHRSObjectType *ahrs,
+                              const AHRSBackendType *backend, void *filter) {
+  /*检查注入后端是否空缺*/
+  if ((ahrs == NULL) || (backend == NULL) || (filter == NULL) ||
+      (backend->Update == NULL) || (backend->Quaternion == NULL)) {
+    return AHRS_InitError;
+  }
+
+  ahrs->backend = backend;
+  ahrs->filter = filter;
+
+  return AHRS_Ok;
+}
+
+/**
+ * @brief 由当前四元数求FRD欧拉角，与后端无关
+ *
+ * @param ahrs AHRSObjectType
+ * @param frd 输出角度值与弧度值，航向角范围[0, 360)
+ */
+void AHRSGetEuler(const AHRSObjectType *ahrs, FRDEulerAngle *frd) {
+  MahonyQuaternionToFRD(AHRSGetQuaternion(ahrs), frd);
+}
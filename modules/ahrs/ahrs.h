@@ -0,0 +1,63 @@
+#ifndef AHRS_H
+#define AHRS_H
+
+#include <stdint.h>
+
+/*各后端共用mahony的输入数据接口与欧拉角类型*/
+#include "mahony.h"
+
+/*AHRS错误类型*/
+typedef enum {
+  AHRS_Ok,
+  AHRS_InitError,
+} AHRSErrorType;
+
+/*姿态解算后端接口(虚函数表)*/
+typedef struct {
+  const char *name; // 后端名称
+  void (*Update)(void *filter, MahonyInput *input,
+                 float dt); // 一次更新，陀螺仪°/s，mag全0时退化为纯IMU
+  const float *(*Quaternion)(const void *filter); // 只读访问四元数状态
+} AHRSBackendType;
+
+/*AHRS对象类型*/
+typedef struct {
+  const AHRSBackendType *backend; // 绑定的解算后端
+  void *filter;                   // 后端滤波器实体，需由对应Init初始化
+} AHRSObjectType;
+
+/*可选后端，各自位于独立源文件，未引用的后端不会被链接*/
+extern const AHRSBackendType AHRS_Mahony;        // MahonyFilterType
+extern const AHRSBackendType AHRS_Madgwick;      // MadgwickFilterType
+extern const AHRSBackendType AHRS_Complementary; // ComplementaryFilterType
+extern const AHRSBackendType AHRS_ESKF;          // ESKFFilterType
+
+/*函数声明*/
+
+AHRSErrorType AHRS_ObjectInit(AHRSObjectType *ahrs,
+                              const AHRSBackendType *backend, void *filter);
+void AHRSGetEuler(const AHRSObjectType *ahrs, FRDEulerAngle *frd);
+
+/**
+ * @brief 使用绑定的后端进行一次姿态解算
+ *
+ * @param ahrs AHRSObjectType
+ * @param input MahonyInput,应放入采集到的姿态数据
+ * @param dt 计算间隔时间(s)
+ */
+static inline void AHRSUpdate(AHRSObjectType *ahrs, MahonyInput *input,
+                              float dt) {
+  ahrs->backend->Update(ahrs->filter, input, dt);
+}
+
+/**
+ * @brief 只读访问当前四元数
+ *
+ * @param ahrs AHRSObjectType
+ * @return const float* [q0, q1, q2, q3]
+ */
+static inline const float *AHRSGetQuaternion(const AHRSObjectType *ahrs) {
+  return ahrs->backend->Quaternion(ahrs->filter);
+}
+
+#endif // !AHRS_H
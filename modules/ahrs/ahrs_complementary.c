@@ -0,0 +1,18 @@
+#include "ahrs.h"
+#include "complementary.h"
+
+static void AHRSComplementaryUpdate(void *filter, MahonyInput *input,
+                                    float dt) {
+  ComplementaryUpdateAHRS((ComplementaryFilterType *)filter, input, dt);
+}
+
+static const float *AHRSComplementaryQuaternion(const void *filter) {
+  return ((const ComplementaryFilterType *)filter)->q;
+}
+
+/*线性互补滤波后端，filter为ComplementaryFilterType*/
+const AHRSBackendType AHRS_Complementary = {
+    .name = "complementary",
+    .Update = AHRSComplementaryUpdate,
+    .Quaternion = AHRSComplementaryQuaternion,
+};
@@ -0,0 +1,17 @@
+#include "ahrs.h"
+#include "eskf.h"
+
+static void AHRSESKFUpdate(void *filter, MahonyInput *input, float dt) {
+  ESKFUpdateAHRS((ESKFFilterType *)filter, input, dt);
+}
+
+static const float *AHRSESKFQuaternion(const void *filter) {
+  return ((const ESKFFilterType *)filter)->q;
+}
+
+/*误差状态卡尔曼滤波后端，filter为ESKFFilterType*/
+const AHRSBackendType AHRS_ESKF = {
+    .name = "eskf",
+    .Update = AHRSESKFUpdate,
+    .Quaternion = AHRSESKFQuaternion,
+};
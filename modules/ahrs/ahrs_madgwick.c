@@ -0,0 +1,17 @@
+#include "ahrs.h"
+#include "madgwick.h"
+
+static void AHRSMadgwickUpdate(void *filter, MahonyInput *input, float dt) {
+  MadgwickUpdateAHRS((MadgwickFilterType *)filter, input, dt);
+}
+
+static const float *AHRSMadgwickQuaternion(const void *filter) {
+  return ((const MadgwickFilterType *)filter)->q;
+}
+
+/*madgwick后端，filter为MadgwickFilterType*/
+const AHRSBackendType AHRS_Madgwick = {
+    .name = "madgwick",
+    .Update = AHRSMadgwickUpdate,
+    .Quaternion = AHRSMadgwickQuaternion,
+};
@@ -0,0 +1,17 @@
+#include "ahrs.h"
+#include "mahony.h"
+
+static void AHRSMahonyUpdate(void *filter, MahonyInput *input, float dt) {
+  MahonyUpdateAHRS((MahonyFilterType *)filter, input, dt);
+}
+
+static const float *AHRSMahonyQuaternion(const void *filter) {
+  return MahonyQuaternion((const MahonyFilterType *)filter);
+}
+
+/*mahony后端，filter为MahonyFilterType*/
+const AHRSBackendType AHRS_Mahony = {
+    .name = "mahony",
+    .Update = AHRSMahonyUpdate,
+    .Quaternion = AHRSMahonyQuaternion,
+};
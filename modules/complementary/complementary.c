@@ -0,0 +1,170 @@
+#include "complementary.h"
+
+static void ComplementaryPropagate(ComplementaryFilterType *ahrs,
+                                   MahonyInput *input,
+                                   float dt); // 陀螺仪积分
+static void ComplementaryCorrect(ComplementaryFilterType *ahrs,
+                                 MahonyInput *input,
+                                 uint8_t useMag); // 加速度计/磁力计修正
+
+/**
+ * @brief 初始化线性互补滤波器
+ *
+ * @param ahrs ComplementaryFilterType
+ * @param accelAlpha 加速度计融合比例，常用0.002~0.02(1kHz)
+ * @param magAlpha 磁力计融合比例，常用0.001~0.01(1kHz)
+ */
+void ComplementaryFilterInit(ComplementaryFilterType *ahrs, float accelAlpha,
+                             float magAlpha) {
+  // 四元数初始化
+  ahrs->q[0] = 1.0f;
+  ahrs->q[1] = 0.0f;
+  ahrs->q[2] = 0.0f;
+  ahrs->q[3] = 0.0f;
+
+  ahrs->accelAlpha = accelAlpha;
+  ahrs->magAlpha = magAlpha;
+}
+
+/**
+ * @brief 互补滤波进行一次计算求得四元数
+ *
+ * @param ahrs ComplementaryFilterType
+ * @param input MahonyInput,陀螺仪单位°/s，与MahonyUpdateAHRS一致
+ * @param dt 计算间隔时间(s)
+ */
+void ComplementaryUpdateAHRS(ComplementaryFilterType *ahrs, MahonyInput *input,
+                             float dt) {
+  // 将陀螺仪度/秒转换为弧度/秒
+  input->gyro.x *= 0.0174533f;
+  input->gyro.y *= 0.0174533f;
+  input->gyro.z *= 0.0174533f;
+
+  ComplementaryPropagate(ahrs, input, dt);
+  ComplementaryCorrect(ahrs, input,
+                       !((input->mag.x == 0.0f) && (input->mag.y == 0.0f) &&
+                         (input->mag.z == 0.0f)));
+}
+
+/**
+ * @brief 互补滤波进行一次计算求得四元数。(当磁力计不可靠时)
+ *
+ * @param ahrs ComplementaryFilterType
+ * @param input MahonyInput,陀螺仪单位rad/s，与MahonyUpdateAHRSIMU一致
+ * @param dt 计算间隔时间(s)
+ */
+void ComplementaryUpdateAHRSIMU(ComplementaryFilterType *ahrs,
+                                MahonyInput *input, float dt) {
+  ComplementaryPropagate(ahrs, input, dt);
+  ComplementaryCorrect(ahrs, input, 0);
+}
+
+/**
+ * @brief 陀螺仪一阶积分预测四元数
+ *
+ * @param ahrs ComplementaryFilterType
+ * @param input MahonyInput,陀螺仪单位rad/s
+ * @param dt 计算间隔时间(s)
+ */
+static void ComplementaryPropagate(ComplementaryFilterType *ahrs,
+                                   MahonyInput *input, float dt) {
+  float gx = input->gyro.x * (0.5f * dt);
+  float gy = input->gyro.y * (0.5f * dt);
+  float gz = input->gyro.z * (0.5f * dt);
+  float qa = ahrs->q[0], qb = ahrs->q[1], qc = ahrs->q[2], qd = ahrs->q[3];
+
+  ahrs->q[0] += (-qb * gx - qc * gy - qd * gz);
+  ahrs->q[1] += (qa * gx + qc * gz - qd * gy);
+  ahrs->q[2] += (qa * gy - qb * gz + qd * gx);
+  ahrs->q[3] += (qa * gz + qb * gy - qc * gx);
+}
+
+/**
+ * @brief 用加速度计(与磁力计)线性修正四元数，并完成规范化
+ *
+ * @param ahrs ComplementaryFilterType
+ * @param input MahonyInput
+ * @param useMag 是否使用磁力计修正航向
+ * @note 将测量的重力方向转到导航系，求出使其对齐Z轴的小角度修正四元数
+ *       [1, a*gy/2, -a*gx/2, 0]，左乘到姿态上；航向同理只绕Z轴修正。
+ *       全程无三角函数，平方根倒数最多三次(加速度、磁场水平分量与四元数规范化，
+ *       不用磁力计时两次)，适合无FPU的内核。
+ */
+static void ComplementaryCorrect(ComplementaryFilterType *ahrs,
+                                 MahonyInput *input, uint8_t useMag) {
+  float recipNorm;
+  float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+  float q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  float gx, gy, mx, my, dx, dy, dz;
+  float p0, p1, p2, p3;
+
+  // 辅助变量避免重复运算(未规范化的q会在最后统一处理)
+  q0q1 = q0 * q1;
+  q0q2 = q0 * q2;
+  q0q3 = q0 * q3;
+  q1q1 = q1 * q1;
+  q1q2 = q1 * q2;
+  q1q3 = q1 * q3;
+  q2q2 = q2 * q2;
+  q2q3 = q2 * q3;
+  q3q3 = q3 * q3;
+
+  // 仅在加速度计测量有效时计算修正
+  if ((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
+      (input->accel.z == 0.0f)) {
+    useMag = 0;
+    dx = 0.0f;
+    dy = 0.0f;
+  } else {
+    // 加速度计测量归一化
+    recipNorm = MahonyInvSqrt(input->accel.x * input->accel.x +
+                              input->accel.y * input->accel.y +
+                              input->accel.z * input->accel.z);
+
+    // 测量重力方向转到导航系(只需水平分量)
+    gx = 2.0f * (input->accel.x * (0.5f - q2q2 - q3q3) +
+                 input->accel.y * (q1q2 - q0q3) +
+                 input->accel.z * (q1q3 + q0q2)) *
+         recipNorm;
+    gy = 2.0f * (input->accel.x * (q1q2 + q0q3) +
+                 input->accel.y * (0.5f - q1q1 - q3q3) +
+                 input->accel.z * (q2q3 - q0q1)) *
+         recipNorm;
+
+    // 倾角修正量(半角)
+    dx = 0.5f * ahrs->accelAlpha * gy;
+    dy = -0.5f * ahrs->accelAlpha * gx;
+  }
+
+  dz = 0.0f;
+  if (useMag) {
+    // 测量磁场方向转到导航系的水平分量，北向应为+X
+    mx = 2.0f *
+         (input->mag.x * (0.5f - q2q2 - q3q3) + input->mag.y * (q1q2 - q0q3) +
+          input->mag.z * (q1q3 + q0q2));
+    my = 2.0f *
+         (input->mag.x * (q1q2 + q0q3) + input->mag.y * (0.5f - q1q1 - q3q3) +
+          input->mag.z * (q2q3 - q0q1));
+    if (!((mx == 0.0f) && (my == 0.0f))) {
+      recipNorm = MahonyInvSqrt(mx * mx + my * my);
+      // 航向修正量(半角)，mx<0时按最大修正方向处理
+      dz = -0.5f * ahrs->magAlpha * my * recipNorm;
+      if (mx < 0.0f) {
+        dz = (my >= 0.0f) ? -0.5f * ahrs->magAlpha : 0.5f * ahrs->magAlpha;
+      }
+    }
+  }
+
+  // 修正四元数左乘: [1, dx, dy, dz] * q
+  p0 = q0 - dx * q1 - dy * q2 - dz * q3;
+  p1 = q1 + dx * q0 + dy * q3 - dz * q2;
+  p2 = q2 - dx * q3 + dy * q0 + dz * q1;
+  p3 = q3 + dx * q2 - dy * q1 + dz * q0;
+
+  // 四元数规范化
+  recipNorm = MahonyInvSqrt(p0 * p0 + p1 * p1 + p2 * p2 + p3 * p3);
+  ahrs->q[0] = p0 * recipNorm;
+  ahrs->q[1] = p1 * recipNorm;
+  ahrs->q[2] = p2 * recipNorm;
+  ahrs->q[3] = p3 * recipNorm;
+}
@@ -0,0 +1,25 @@
+#ifndef COMPLEMENTARY_H
+#define COMPLEMENTARY_H
+
+#include <stdint.h>
+
+/*复用mahony的输入数据接口*/
+#include "mahony.h"
+
+/*线性互补滤波器数据类型*/
+typedef struct {
+  float q[4];       // 四元数状态[q0, q1, q2, q3]
+  float accelAlpha; // 加速度计修正系数(每次更新的融合比例,0~1)
+  float magAlpha;   // 磁力计修正系数(每次更新的融合比例,0~1)
+} ComplementaryFilterType;
+
+/*函数声明*/
+
+void ComplementaryFilterInit(ComplementaryFilterType *ahrs, float accelAlpha,
+                             float magAlpha);
+void ComplementaryUpdateAHRS(ComplementaryFilterType *ahrs, MahonyInput *input,
+                             float dt);
+void ComplementaryUpdateAHRSIMU(ComplementaryFilterType *ahrs,
+                                MahonyInput *input, float dt);
+
+#endif // !COMPLEMENTARY_H
@@ -0,0 +1,324 @@
+#include "eskf.h"
+#include <stddef.h>
+
+/*对称3x3块的上三角下标*/
+static const uint8_t symIdx[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+
+static void ESKFPredict(ESKFFilterType *eskf, const float w[3],
+                        float dt); // 名义状态传播与协方差预测
+static void ESKFScalarUpdate(ESKFFilterType *eskf, const float h[3], float y,
+                             float r, float dx[6]); // 标量观测更新
+static void ESKFCorrect(ESKFFilterType *eskf, MahonyInput *input,
+                        uint8_t useMag); // 加速度计/磁力计修正
+
+/**
+ * @brief 初始化ESKF姿态估计器
+ *
+ * @param eskf ESKFFilterType
+ * @param config 噪声参数，NULL则使用ESKF_DEFAULT_CONFIG
+ */
+void ESKFFilterInit(ESKFFilterType *eskf, const ESKFConfig *config) {
+  const ESKFConfig defaultConfig = ESKF_DEFAULT_CONFIG;
+  uint8_t i, j;
+
+  eskf->config = (config == NULL) ? defaultConfig : *config;
+
+  // 四元数与零偏初始化
+  eskf->q[0] = 1.0f;
+  eskf->q[1] = 0.0f;
+  eskf->q[2] = 0.0f;
+  eskf->q[3] = 0.0f;
+  eskf->bias[0] = 0.0f;
+  eskf->bias[1] = 0.0f;
+  eskf->bias[2] = 0.0f;
+
+  // 协方差初始化为对角阵
+  for (i = 0; i < 6; i++) {
+    eskf->P.tt[i] = 0.0f;
+    eskf->P.bb[i] = 0.0f;
+  }
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      eskf->P.tb[i][j] = 0.0f;
+    }
+    eskf->P.tt[symIdx[i][i]] = eskf->config.initAttStd * eskf->config.initAttStd;
+    eskf->P.bb[symIdx[i][i]] =
+        eskf->config.initBiasStd * eskf->config.initBiasStd;
+  }
+}
+
+/**
+ * @brief ESKF进行一次计算求得四元数与陀螺仪零偏
+ *
+ * @param eskf ESKFFilterType
+ * @param input MahonyInput,陀螺仪单位°/s，与MahonyUpdateAHRS一致
+ * @param dt 计算间隔时间(s)
+ */
+void ESKFUpdateAHRS(ESKFFilterType *eskf, MahonyInput *input, float dt) {
+  // 将陀螺仪度/秒转换为弧度/秒
+  input->gyro.x *= 0.0174533f;
+  input->gyro.y *= 0.0174533f;
+  input->gyro.z *= 0.0174533f;
+
+  // 如果磁力计测量无效，则使用纯IMU算法
+  if ((input->mag.x == 0.0f) && (input->mag.y == 0.0f) &&
+      (input->mag.z == 0.0f)) {
+    ESKFUpdateAHRSIMU(eskf, input, dt);
+    return;
+  }
+
+  float w[3] = {input->gyro.x - eskf->bias[0], input->gyro.y - eskf->bias[1],
+                input->gyro.z - eskf->bias[2]};
+  ESKFPredict(eskf, w, dt);
+  ESKFCorrect(eskf, input, 1);
+}
+
+/**
+ * @brief ESKF进行一次计算求得四元数与陀螺仪零偏。(当磁力计不可靠时)
+ *
+ * @param eskf ESKFFilterType
+ * @param input MahonyInput,陀螺仪单位rad/s，与MahonyUpdateAHRSIMU一致
+ * @param dt 计算间隔时间(s)
+ */
+void ESKFUpdateAHRSIMU(ESKFFilterType *eskf, MahonyInput *input, float dt) {
+  float w[3] = {input->gyro.x - eskf->bias[0], input->gyro.y - eskf->bias[1],
+                input->gyro.z - eskf->bias[2]};
+  ESKFPredict(eskf, w, dt);
+  ESKFCorrect(eskf, input, 0);
+}
+
+/**
+ * @brief 名义四元数积分，误差协方差 P = F*P*F^T + Q
+ *
+ * @param eskf ESKFFilterType
+ * @param w 去零偏后的角速度(rad/s)
+ * @param dt 计算间隔时间(s)
+ * @note F = [A -I*dt; 0 I], A = I - [w×]*dt。按块展开：
+ *       tt' = A*tt*A^T - dt*(N + N^T) + dt²*bb + Qθ, N = A*tb
+ *       tb' = N - dt*bb,  bb' = bb + Qb
+ *       对称块只计算上三角，零块与单位块不参与运算
+ */
+static void ESKFPredict(ESKFFilterType *eskf, const float w[3], float dt) {
+  float A[3][3], M[3][3], N[3][3];
+  float hx = 0.5f * w[0] * dt, hy = 0.5f * w[1] * dt, hz = 0.5f * w[2] * dt;
+  float qa = eskf->q[0], qb = eskf->q[1], qc = eskf->q[2], qd = eskf->q[3];
+  float recipNorm, sum, dt2 = dt * dt;
+  float qTheta = eskf->config.gyroNoise * eskf->config.gyroNoise * dt2;
+  float qBias =
+      eskf->config.gyroBiasNoise * eskf->config.gyroBiasNoise * dt;
+  uint8_t i, j, k;
+
+  // 名义状态: q = q * [1, w*dt/2]
+  eskf->q[0] += (-qb * hx - qc * hy - qd * hz);
+  eskf->q[1] += (qa * hx + qc * hz - qd * hy);
+  eskf->q[2] += (qa * hy - qb * hz + qd * hx);
+  eskf->q[3] += (qa * hz + qb * hy - qc * hx);
+  recipNorm = MahonyInvSqrt(eskf->q[0] * eskf->q[0] + eskf->q[1] * eskf->q[1] +
+                            eskf->q[2] * eskf->q[2] + eskf->q[3] * eskf->q[3]);
+  eskf->q[0] *= recipNorm;
+  eskf->q[1] *= recipNorm;
+  eskf->q[2] *= recipNorm;
+  eskf->q[3] *= recipNorm;
+
+  // A = I - [w×]*dt
+  A[0][0] = 1.0f;
+  A[0][1] = w[2] * dt;
+  A[0][2] = -w[1] * dt;
+  A[1][0] = -w[2] * dt;
+  A[1][1] = 1.0f;
+  A[1][2] = w[0] * dt;
+  A[2][0] = w[1] * dt;
+  A[2][1] = -w[0] * dt;
+  A[2][2] = 1.0f;
+
+  // M = A*tt, N = A*tb
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      M[i][j] = 0.0f;
+      N[i][j] = 0.0f;
+      for (k = 0; k < 3; k++) {
+        M[i][j] += A[i][k] * eskf->P.tt[symIdx[k][j]];
+        N[i][j] += A[i][k] * eskf->P.tb[k][j];
+      }
+    }
+  }
+
+  // tt' = M*A^T - dt*(N + N^T) + dt²*bb + Qθ (仅上三角)
+  for (i = 0; i < 3; i++) {
+    for (j = i; j < 3; j++) {
+      sum = M[i][0] * A[j][0] + M[i][1] * A[j][1] + M[i][2] * A[j][2];
+      sum -= dt * (N[i][j] + N[j][i]);
+      sum += dt2 * eskf->P.bb[symIdx[i][j]];
+      eskf->P.tt[symIdx[i][j]] = sum;
+    }
+    eskf->P.tt[symIdx[i][i]] += qTheta;
+  }
+
+  // tb' = N - dt*bb
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      eskf->P.tb[i][j] = N[i][j] - dt * eskf->P.bb[symIdx[i][j]];
+    }
+  }
+
+  // bb' = bb + Qb
+  eskf->P.bb[0] += qBias;
+  eskf->P.bb[3] += qBias;
+  eskf->P.bb[5] += qBias;
+}
+
+/**
+ * @brief 标量观测的序贯更新，观测只与姿态误差有关
+ *
+ * @param eskf ESKFFilterType
+ * @param h 观测矩阵的姿态部分(1x3)，零偏部分恒为0
+ * @param y 观测残差
+ * @param r 观测噪声方差
+ * @param dx 累计的误差状态[δθ, δb]
+ * @note 观测噪声互不相关，逐个标量更新即可避免矩阵求逆
+ */
+static void ESKFScalarUpdate(ESKFFilterType *eskf, const float h[3], float y,
+                             float r, float dx[6]) {
+  float u[3], v[3];
+  float s, recipS, innov;
+  uint8_t i, j;
+
+  // u = tt*h, v = tb^T*h
+  for (i = 0; i < 3; i++) {
+    u[i] = eskf->P.tt[symIdx[i][0]] * h[0] + eskf->P.tt[symIdx[i][1]] * h[1] +
+           eskf->P.tt[symIdx[i][2]] * h[2];
+    v[i] = eskf->P.tb[0][i] * h[0] + eskf->P.tb[1][i] * h[1] +
+           eskf->P.tb[2][i] * h[2];
+  }
+
+  s = h[0] * u[0] + h[1] * u[1] + h[2] * u[2] + r;
+  recipS = 1.0f / s;
+  innov = (y - (h[0] * dx[0] + h[1] * dx[1] + h[2] * dx[2])) * recipS;
+
+  // dx += K*innov, K = [u; v]/s
+  for (i = 0; i < 3; i++) {
+    dx[i] += u[i] * innov;
+    dx[i + 3] += v[i] * innov;
+  }
+
+  // P -= K*K^T*s
+  for (i = 0; i < 3; i++) {
+    for (j = i; j < 3; j++) {
+      eskf->P.tt[symIdx[i][j]] -= u[i] * u[j] * recipS;
+      eskf->P.bb[symIdx[i][j]] -= v[i] * v[j] * recipS;
+    }
+    for (j = 0; j < 3; j++) {
+      eskf->P.tb[i][j] -= u[i] * v[j] * recipS;
+    }
+  }
+}
+
+/**
+ * @brief 加速度计(与磁力计)观测更新，并将误差状态注入名义状态
+ *
+ * @param eskf ESKFFilterType
+ * @param input MahonyInput
+ * @param useMag 是否使用磁力计修正航向
+ * @note 加速度计: 残差a-h，h = R^T*[0,0,1]，观测矩阵为[h×]
+ *       磁力计: 只观测航向，残差为导航系水平磁场的偏角，观测矩阵为-R的第3行
+ */
+static void ESKFCorrect(ESKFFilterType *eskf, MahonyInput *input,
+                        uint8_t useMag) {
+  float dx[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  float q0 = eskf->q[0], q1 = eskf->q[1], q2 = eskf->q[2], q3 = eskf->q[3];
+  float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+  float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+  float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+  float recipNorm, normSq, deviation;
+  float ax, ay, az, mx, my, mz, wx, wy, psi;
+  float g[3], row[3];
+  float ra = eskf->config.accelNoise * eskf->config.accelNoise;
+  uint8_t updated = 0;
+
+  // 加速度计观测
+  normSq = input->accel.x * input->accel.x + input->accel.y * input->accel.y +
+           input->accel.z * input->accel.z;
+  if (normSq > 0.0f) {
+    recipNorm = MahonyInvSqrt(normSq);
+    deviation = normSq * recipNorm / eskf->config.gravity - 1.0f;
+    if (deviation < 0.0f) {
+      deviation = -deviation;
+    }
+
+    if ((eskf->config.accelGate <= 0.0f) ||
+        (deviation < eskf->config.accelGate)) {
+      ax = input->accel.x * recipNorm;
+      ay = input->accel.y * recipNorm;
+      az = input->accel.z * recipNorm;
+
+      // 估计的重力方向
+      g[0] = 2.0f * (q1q3 - q0q2);
+      g[1] = 2.0f * (q0q1 + q2q3);
+      g[2] = q0q0 - q1q1 - q2q2 + q3q3;
+
+      // [g×]逐行
+      row[0] = 0.0f;
+      row[1] = -g[2];
+      row[2] = g[1];
+      ESKFScalarUpdate(eskf, row, ax - g[0], ra, dx);
+      row[0] = g[2];
+      row[1] = 0.0f;
+      row[2] = -g[0];
+      ESKFScalarUpdate(eskf, row, ay - g[1], ra, dx);
+      row[0] = -g[1];
+      row[1] = g[0];
+      row[2] = 0.0f;
+      ESKFScalarUpdate(eskf, row, az - g[2], ra, dx);
+      updated = 1;
+    }
+  }
+
+  // 磁力计航向观测
+  if (useMag) {
+    mx = input->mag.x;
+    my = input->mag.y;
+    mz = input->mag.z;
+
+    // 测量磁场转到导航系的水平分量，北向应为+X
+    wx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) +
+                 mz * (q1q3 + q0q2));
+    wy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) +
+                 mz * (q2q3 - q0q1));
+    if (!((wx == 0.0f) && (wy == 0.0f))) {
+      // 小角度偏角，反向时限幅为±1rad
+      recipNorm = MahonyInvSqrt(wx * wx + wy * wy);
+      psi = wy * recipNorm;
+      if (wx < 0.0f) {
+        psi = (wy >= 0.0f) ? 1.0f : -1.0f;
+      }
+
+      row[0] = -2.0f * (q1q3 - q0q2);
+      row[1] = -2.0f * (q2q3 + q0q1);
+      row[2] = -(1.0f - 2.0f * (q1q1 + q2q2));
+      ESKFScalarUpdate(eskf, row, psi,
+                       eskf->config.magNoise * eskf->config.magNoise, dx);
+      updated = 1;
+    }
+  }
+
+  if (!updated) {
+    return;
+  }
+
+  // 误差注入: q = q * [1, δθ/2], b += δb
+  float hx = 0.5f * dx[0], hy = 0.5f * dx[1], hz = 0.5f * dx[2];
+  eskf->q[0] = q0 - q1 * hx - q2 * hy - q3 * hz;
+  eskf->q[1] = q1 + q0 * hx + q2 * hz - q3 * hy;
+  eskf->q[2] = q2 + q0 * hy - q1 * hz + q3 * hx;
+  eskf->q[3] = q3 + q0 * hz + q1 * hy - q2 * hx;
+  recipNorm = MahonyInvSqrt(eskf->q[0] * eskf->q[0] + eskf->q[1] * eskf->q[1] +
+                            eskf->q[2] * eskf->q[2] + eskf->q[3] * eskf->q[3]);
+  eskf->q[0] *= recipNorm;
+  eskf->q[1] *= recipNorm;
+  eskf->q[2] *= recipNorm;
+  eskf->q[3] *= recipNorm;
+
+  eskf->bias[0] += dx[3];
+  eskf->bias[1] += dx[4];
+  eskf->bias[2] += dx[5];
+}
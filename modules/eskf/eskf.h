@@ -0,0 +1,55 @@
+#ifndef ESKF_H
+#define ESKF_H
+
+#include <stdint.h>
+
+/*复用mahony的输入数据接口*/
+#include "mahony.h"
+
+/*ESKF配置(噪声参数)*/
+typedef struct {
+  float gyroNoise;     // 陀螺仪角速度噪声标准差(rad/s)
+  float gyroBiasNoise; // 陀螺仪零偏随机游走(rad/s/√s)，越大零偏跟踪越快
+  float accelNoise;    // 归一化加速度方向噪声标准差
+  float magNoise;      // 磁力计航向噪声标准差(rad)
+  float initAttStd;    // 初始姿态误差标准差(rad)
+  float initBiasStd;   // 初始零偏标准差(rad/s)
+  float gravity;       // 重力加速度模长，与输入加速度同单位
+  float accelGate; // 加速度模长相对1g偏离超过该比例时跳过加速度修正，0为不判断
+} ESKFConfig;
+
+/*默认配置，适用于MPU6050一类消费级IMU*/
+#define ESKF_DEFAULT_CONFIG                                                    \
+  {                                                                            \
+      .gyroNoise = 0.005f,                                                     \
+      .gyroBiasNoise = 0.0002f,                                                \
+      .accelNoise = 0.05f,                                                     \
+      .magNoise = 0.1f,                                                        \
+      .initAttStd = 0.5f,                                                      \
+      .initBiasStd = 0.05f,                                                    \
+      .gravity = 9.8f,                                                         \
+      .accelGate = 0.2f,                                                       \
+  }
+
+/*误差状态协方差，6x6对称阵按块存储，只保存上三角共21个数*/
+typedef struct {
+  float tt[6];    // 姿态误差块(对称) [00 01 02 11 12 22]
+  float tb[3][3]; // 姿态-零偏互协方差块
+  float bb[6];    // 零偏块(对称) [00 01 02 11 12 22]
+} ESKFCovariance;
+
+/*ESKF姿态估计器数据类型*/
+typedef struct {
+  float q[4];        // 名义四元数状态[q0, q1, q2, q3]
+  float bias[3];     // 陀螺仪零偏估计(rad/s)
+  ESKFCovariance P;  // 误差状态协方差
+  ESKFConfig config; // 初始化配置
+} ESKFFilterType;
+
+/*函数声明*/
+
+void ESKFFilterInit(ESKFFilterType *eskf, const ESKFConfig *config);
+void ESKFUpdateAHRS(ESKFFilterType *eskf, MahonyInput *input, float dt);
+void ESKFUpdateAHRSIMU(ESKFFilterType *eskf, MahonyInput *input, float dt);
+
+#endif // !ESKF_H
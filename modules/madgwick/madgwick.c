@@ -0,0 +1,254 @@
+#include "madgwick.h"
+#include <math.h>
+
+/**
+ * @brief 初始化madgwick滤波器
+ *
+ * @param ahrs MadgwickFilterType
+ * @param beta 梯度下降步长，常用0.033~0.1
+ */
+void MadgwickFilterInit(MadgwickFilterType *ahrs, float beta) {
+  // 四元数初始化
+  ahrs->q[0] = 1.0f;
+  ahrs->q[1] = 0.0f;
+  ahrs->q[2] = 0.0f;
+  ahrs->q[3] = 0.0f;
+
+  ahrs->beta = beta;
+}
+
+/**
+ * @brief madgwick进行一次计算求得四元数
+ *
+ * @param ahrs MadgwickFilterType
+ * @param input MahonyInput,陀螺仪单位°/s，与MahonyUpdateAHRS一致
+ * @param dt 计算间隔时间(s)
+ */
+void MadgwickUpdateAHRS(MadgwickFilterType *ahrs, MahonyInput *input,
+                        float dt) {
+  float recipNorm;
+  float s0, s1, s2, s3;
+  float qDot0, qDot1, qDot2, qDot3;
+  float hx, hy;
+  float _2q0mx, _2q0my, _2q0mz, _2q1mx, _2bx, _2bz, _4bx, _4bz;
+  float _2q0, _2q1, _2q2, _2q3, _2q0q2, _2q2q3;
+  float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+  float ax, ay, az, mx, my, mz;
+
+  // 将陀螺仪度/秒转换为弧度/秒
+  input->gyro.x *= 0.0174533f;
+  input->gyro.y *= 0.0174533f;
+  input->gyro.z *= 0.0174533f;
+
+  // 如果磁力计测量无效，则使用纯IMU算法
+  if ((input->mag.x == 0.0f) && (input->mag.y == 0.0f) &&
+      (input->mag.z == 0.0f)) {
+    MadgwickUpdateAHRSIMU(ahrs, input, dt);
+    return;
+  }
+
+  // 陀螺仪给出的四元数变化率
+  qDot0 = 0.5f * (-q1 * input->gyro.x - q2 * input->gyro.y -
+                  q3 * input->gyro.z);
+  qDot1 = 0.5f * (q0 * input->gyro.x + q2 * input->gyro.z -
+                  q3 * input->gyro.y);
+  qDot2 = 0.5f * (q0 * input->gyro.y - q1 * input->gyro.z +
+                  q3 * input->gyro.x);
+  qDot3 = 0.5f * (q0 * input->gyro.z + q1 * input->gyro.y -
+                  q2 * input->gyro.x);
+
+  // 仅在加速度计测量有效时计算反馈（避免加速度计归一化中出现 NaN）
+  if (!((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
+        (input->accel.z == 0.0f))) {
+
+    // 加速度计与磁强计测量归一化
+    recipNorm = MahonyInvSqrt(input->accel.x * input->accel.x +
+                              input->accel.y * input->accel.y +
+                              input->accel.z * input->accel.z);
+    ax = input->accel.x * recipNorm;
+    ay = input->accel.y * recipNorm;
+    az = input->accel.z * recipNorm;
+    recipNorm = MahonyInvSqrt(input->mag.x * input->mag.x +
+                              input->mag.y * input->mag.y +
+                              input->mag.z * input->mag.z);
+    mx = input->mag.x * recipNorm;
+    my = input->mag.y * recipNorm;
+    mz = input->mag.z * recipNorm;
+
+    // 辅助变量避免重复运算
+    _2q0mx = 2.0f * q0 * mx;
+    _2q0my = 2.0f * q0 * my;
+    _2q0mz = 2.0f * q0 * mz;
+    _2q1mx = 2.0f * q1 * mx;
+    _2q0 = 2.0f * q0;
+    _2q1 = 2.0f * q1;
+    _2q2 = 2.0f * q2;
+    _2q3 = 2.0f * q3;
+    _2q0q2 = 2.0f * q0 * q2;
+    _2q2q3 = 2.0f * q2 * q3;
+    q0q0 = q0 * q0;
+    q0q1 = q0 * q1;
+    q0q2 = q0 * q2;
+    q0q3 = q0 * q3;
+    q1q1 = q1 * q1;
+    q1q2 = q1 * q2;
+    q1q3 = q1 * q3;
+    q2q2 = q2 * q2;
+    q2q3 = q2 * q3;
+    q3q3 = q3 * q3;
+
+    // 地球磁场的参考方向
+    hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 +
+         _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+    hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 +
+         my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+    _2bx = sqrtf(hx * hx + hy * hy);
+    _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 +
+           _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+    _4bx = 2.0f * _2bx;
+    _4bz = 2.0f * _2bz;
+
+    // 梯度下降修正方向
+    s0 = -_2q2 * (2.0f * q1q3 - _2q0q2 - ax) +
+         _2q1 * (2.0f * q0q1 + _2q2q3 - ay) -
+         _2bz * q2 *
+             (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) +
+         (-_2bx * q3 + _2bz * q1) *
+             (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) +
+         _2bx * q2 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s1 = _2q3 * (2.0f * q1q3 - _2q0q2 - ax) +
+         _2q0 * (2.0f * q0q1 + _2q2q3 - ay) -
+         4.0f * q1 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) +
+         _2bz * q3 *
+             (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) +
+         (_2bx * q2 + _2bz * q0) *
+             (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) +
+         (_2bx * q3 - _4bz * q1) *
+             (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s2 = -_2q0 * (2.0f * q1q3 - _2q0q2 - ax) +
+         _2q3 * (2.0f * q0q1 + _2q2q3 - ay) -
+         4.0f * q2 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) +
+         (-_4bx * q2 - _2bz * q0) *
+             (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) +
+         (_2bx * q1 + _2bz * q3) *
+             (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) +
+         (_2bx * q0 - _4bz * q2) *
+             (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s3 = _2q1 * (2.0f * q1q3 - _2q0q2 - ax) +
+         _2q2 * (2.0f * q0q1 + _2q2q3 - ay) +
+         (-_4bx * q3 + _2bz * q1) *
+             (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) +
+         (-_2bx * q0 + _2bz * q2) *
+             (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) +
+         _2bx * q1 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+
+    // 修正方向归一化后按beta反馈，已对准时修正方向为零则跳过
+    if (!((s0 == 0.0f) && (s1 == 0.0f) && (s2 == 0.0f) && (s3 == 0.0f))) {
+      recipNorm = MahonyInvSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+      qDot0 -= ahrs->beta * s0 * recipNorm;
+      qDot1 -= ahrs->beta * s1 * recipNorm;
+      qDot2 -= ahrs->beta * s2 * recipNorm;
+      qDot3 -= ahrs->beta * s3 * recipNorm;
+    }
+  }
+
+  // 积分四元数的变化率
+  q0 += qDot0 * dt;
+  q1 += qDot1 * dt;
+  q2 += qDot2 * dt;
+  q3 += qDot3 * dt;
+
+  // 四元数规范化
+  recipNorm = MahonyInvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+  ahrs->q[0] = q0 * recipNorm;
+  ahrs->q[1] = q1 * recipNorm;
+  ahrs->q[2] = q2 * recipNorm;
+  ahrs->q[3] = q3 * recipNorm;
+}
+
+/**
+ * @brief madgwick进行一次计算求得四元数。(当磁力计不可靠时)
+ *
+ * @param ahrs MadgwickFilterType
+ * @param input MahonyInput,陀螺仪单位rad/s，与MahonyUpdateAHRSIMU一致
+ * @param dt 计算间隔时间(s)
+ */
+void MadgwickUpdateAHRSIMU(MadgwickFilterType *ahrs, MahonyInput *input,
+                           float dt) {
+  float recipNorm;
+  float s0, s1, s2, s3;
+  float qDot0, qDot1, qDot2, qDot3;
+  float _2q0, _2q1, _2q2, _2q3, _4q0, _4q1, _4q2, _8q1, _8q2;
+  float q0q0, q1q1, q2q2, q3q3;
+  float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+  float ax, ay, az;
+
+  // 陀螺仪给出的四元数变化率
+  qDot0 = 0.5f * (-q1 * input->gyro.x - q2 * input->gyro.y -
+                  q3 * input->gyro.z);
+  qDot1 = 0.5f * (q0 * input->gyro.x + q2 * input->gyro.z -
+                  q3 * input->gyro.y);
+  qDot2 = 0.5f * (q0 * input->gyro.y - q1 * input->gyro.z +
+                  q3 * input->gyro.x);
+  qDot3 = 0.5f * (q0 * input->gyro.z + q1 * input->gyro.y -
+                  q2 * input->gyro.x);
+
+  // 仅在加速度计测量有效时计算反馈（避免加速度计归一化中出现 NaN）
+  if (!((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
+        (input->accel.z == 0.0f))) {
+
+    // 使加速度计测量归一化
+    recipNorm = MahonyInvSqrt(input->accel.x * input->accel.x +
+                              input->accel.y * input->accel.y +
+                              input->accel.z * input->accel.z);
+    ax = input->accel.x * recipNorm;
+    ay = input->accel.y * recipNorm;
+    az = input->accel.z * recipNorm;
+
+    // 辅助变量避免重复运算
+    _2q0 = 2.0f * q0;
+    _2q1 = 2.0f * q1;
+    _2q2 = 2.0f * q2;
+    _2q3 = 2.0f * q3;
+    _4q0 = 4.0f * q0;
+    _4q1 = 4.0f * q1;
+    _4q2 = 4.0f * q2;
+    _8q1 = 8.0f * q1;
+    _8q2 = 8.0f * q2;
+    q0q0 = q0 * q0;
+    q1q1 = q1 * q1;
+    q2q2 = q2 * q2;
+    q3q3 = q3 * q3;
+
+    // 梯度下降修正方向
+    s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 +
+         _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+    s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 +
+         _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+    s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+
+    // 静止且姿态已对准时修正方向为零，此时不做归一化
+    if (!((s0 == 0.0f) && (s1 == 0.0f) && (s2 == 0.0f) && (s3 == 0.0f))) {
+      recipNorm = MahonyInvSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+      qDot0 -= ahrs->beta * s0 * recipNorm;
+      qDot1 -= ahrs->beta * s1 * recipNorm;
+      qDot2 -= ahrs->beta * s2 * recipNorm;
+      qDot3 -= ahrs->beta * s3 * recipNorm;
+    }
+  }
+
+  // 积分四元数的变化率
+  q0 += qDot0 * dt;
+  q1 += qDot1 * dt;
+  q2 += qDot2 * dt;
+  q3 += qDot3 * dt;
+
+  // 四元数规范化
+  recipNorm = MahonyInvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+  ahrs->q[0] = q0 * recipNorm;
+  ahrs->q[1] = q1 * recipNorm;
+  ahrs->q[2] = q2 * recipNorm;
+  ahrs->q[3] = q3 * recipNorm;
+}
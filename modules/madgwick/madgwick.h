@@ -0,0 +1,23 @@
+#ifndef MADGWICK_H
+#define MADGWICK_H
+
+#include <stdint.h>
+
+/*复用mahony的输入数据接口*/
+#include "mahony.h"
+
+/*Madgwick梯度下降滤波器数据类型*/
+typedef struct {
+  float q[4]; // 四元数状态[q0, q1, q2, q3]
+  float beta; // 梯度下降步长(陀螺仪测量误差)
+} MadgwickFilterType;
+
+/*函数声明*/
+
+void MadgwickFilterInit(MadgwickFilterType *ahrs, float beta);
+void MadgwickUpdateAHRS(MadgwickFilterType *ahrs, MahonyInput *input,
+                        float dt);
+void MadgwickUpdateAHRSIMU(MadgwickFilterType *ahrs, MahonyInput *input,
+                           float dt);
+
+#endif // !MADGWICK_H
@@ -1,14 +1,54 @@
 #include "mahony.h"
 #include <math.h>
-
-float InvSqrt(float x);
+#include <string.h>
+
+#if (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_SSE)
+#if !defined(__SSE__) && !defined(_M_X64)
+#error "MAHONY_INVSQRT_SSE requires an x86 target with SSE"
+#endif
+#include <xmmintrin.h>
+#endif
+
+static float MahonyAdaptiveTwoKp(const MahonyFilterType *ahrs,
+                                 float accelNorm); // 自适应比例增益
+static void MahonyIntegrate(MahonyFilterType *ahrs, float gx, float gy,
+                            float gz, float dt); // 四元数积分
+static void MahonyUpdateCore(MahonyFilterType *ahrs, MahonyInput *input,
+                             uint8_t useMag, float dt); // 反馈+积分
+static uint8_t MahonyFeedbackError(MahonyFilterType *ahrs, MahonyInput *input,
+                                   uint8_t useMag, float halfe[3],
+                                   float *twoKp); // 反馈误差
+static void MahonyAccumulateIntegral(MahonyFilterType *ahrs,
+                                     const float halfe[3],
+                                     float dt); // 积分反馈
+
+/*磁力计测量无效(全0)*/
+#define MAHONY_MAG_ABSENT(input)                                               \
+  (((input)->mag.x == 0.0f) && ((input)->mag.y == 0.0f) &&                     \
+   ((input)->mag.z == 0.0f))
+
+/*本次更新是否使用磁力计: 配置允许且测量有效*/
+#define MAHONY_USE_MAG(ahrs, input)                                            \
+  ((ahrs)->config.useMagnetometer && !MAHONY_MAG_ABSENT(input))
 
 /**
- * @brief 初始化mahony滤波器
+ * @brief 使用默认配置初始化mahony滤波器
  *
  * @param ahrs MahonyFilterType
  */
 void MahonyFilterCoreInit(MahonyFilterType *ahrs) {
+  const MahonyConfig config = MAHONY_DEFAULT_CONFIG;
+
+  MahonyFilterInit(ahrs, &config);
+}
+
+/**
+ * @brief 按配置初始化mahony滤波器
+ *
+ * @param ahrs MahonyFilterType
+ * @param config 增益、计算周期与自适应增益配置
+ */
+void MahonyFilterInit(MahonyFilterType *ahrs, const MahonyConfig *config) {
   // 四元数初始化
   ahrs->filter.q[0] = 1.0f;
   ahrs->filter.q[1] = 0.0f;
@@ -16,18 +56,39 @@ void MahonyFilterCoreInit(MahonyFilterType *ahrs) {
   ahrs->filter.q[3] = 0.0f;
 
   // 增益系数
-  ahrs->filter.twoKp = 2.0f * 4.3f;
-  ahrs->filter.twoKi = 2.0f * 0.1f;
+  ahrs->config = *config;
+  MahonySetGains(ahrs, config->kp, config->ki);
 
   // 误差积分初始化
   ahrs->filter.integralFB[0] = 0.0f;
   ahrs->filter.integralFB[1] = 0.0f;
   ahrs->filter.integralFB[2] = 0.0f;
+  ahrs->filter.initialized = 1;
 
-  // 配置项
-  ahrs->samplePeriod = 0.0f;
-  ahrs->useMagnetometer = 0; // 默认信任磁力计
+  // 运行状态
   ahrs->lastUpdateTime = 0;
+  ahrs->correctionElapsed = 0.0f;
+  ahrs->correctionCount = 0;
+
+  // 输出缓存
+  ahrs->frd = (FRDEulerAngle){0};
+  ahrs->ned = (NEDEulerAngle){0};
+  ahrs->cacheValid = 0;
+}
+
+/**
+ * @brief 运行时修改增益
+ *
+ * @param ahrs MahonyFilterType
+ * @param kp 比例增益
+ * @param ki 积分增益
+ * @note 自适应模式下kp作为收敛结束后的稳态增益
+ */
+void MahonySetGains(MahonyFilterType *ahrs, float kp, float ki) {
+  ahrs->config.kp = kp;
+  ahrs->config.ki = ki;
+  ahrs->filter.twoKp = 2.0f * kp;
+  ahrs->filter.twoKi = 2.0f * ki;
 }
 
 /**
@@ -35,272 +96,508 @@ void MahonyFilterCoreInit(MahonyFilterType *ahrs) {
  *
  * @param ahrs MahonyFilterType
  * @param input MahonyInput,应放入采集到的姿态数据。
- * @param dt 计算间隔时间
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
  */
 void MahonyUpdateAHRS(MahonyFilterType *ahrs, MahonyInput *input, float dt) {
-  float recipNorm;
-  float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
-  float hx, hy, bx, bz;
-  float halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
-  float halfex, halfey, halfez;
-  float qa, qb, qc;
-
   // 将陀螺仪度/秒转换为弧度/秒
   input->gyro.x *= 0.0174533f;
   input->gyro.y *= 0.0174533f;
   input->gyro.z *= 0.0174533f;
 
-  // 如果磁力计测量无效，则使用纯IMU算法
-  if ((input->mag.x == 0.0f) && (input->mag.y == 0.0f) &&
-      (input->mag.z == 0.0f)) {
-    MahonyUpdateAHRSIMU(ahrs, input, dt);
+  // 未启用磁力计或磁力计测量无效，则使用纯IMU算法
+  MahonyUpdateCore(ahrs, input, MAHONY_USE_MAG(ahrs, input), dt);
+}
+
+/**
+ * @brief mahony进行一次计算求得四元数。(当磁力计不可靠时)
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,应放入采集到的姿态数据。
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
+ */
+void MahonyUpdateAHRSIMU(MahonyFilterType *ahrs, MahonyInput *input, float dt) {
+  MahonyUpdateCore(ahrs, input, 0, dt);
+}
+
+/**
+ * @brief 仅用陀螺仪传播四元数，可在IMU全速率下调用
+ *
+ * @param ahrs MahonyFilterType
+ * @param gx 角速度x(rad/s)
+ * @param gy 角速度y(rad/s)
+ * @param gz 角速度z(rad/s)
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
+ * @note 积分反馈(零偏补偿)每步都会施加；比例反馈由MahonyCorrect一次性施加
+ */
+void MahonyPropagate(MahonyFilterType *ahrs, float gx, float gy, float gz,
+                     float dt) {
+  if (dt <= 0.0f) {
+    dt = ahrs->config.samplePeriod;
+  }
+
+  MahonyIntegrate(ahrs, gx + ahrs->filter.integralFB[0],
+                  gy + ahrs->filter.integralFB[1],
+                  gz + ahrs->filter.integralFB[2], dt);
+  ahrs->lastUpdateTime += dt;
+  ahrs->correctionElapsed += dt;
+}
+
+/**
+ * @brief 用加速度计(与磁力计)修正四元数，可降频或在新磁力计数据到来时调用
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,只使用accel与mag，未启用磁力计或mag全0时只用加速度计
+ * @note 修正量按距上次修正的累计传播时间缩放，与每步修正的结果一阶等价
+ */
+void MahonyCorrect(MahonyFilterType *ahrs, MahonyInput *input) {
+  float halfe[3];
+  float twoKp;
+  float elapsed = ahrs->correctionElapsed;
+
+  if (elapsed <= 0.0f) {
+    elapsed = ahrs->config.samplePeriod;
+  }
+  ahrs->correctionElapsed = 0.0f;
+
+  if (!MahonyFeedbackError(ahrs, input, MAHONY_USE_MAG(ahrs, input), halfe,
+                           &twoKp)) {
     return;
   }
 
-  // 仅在加速度计测量有效时计算反馈（避免加速度计归一化中出现 NaN）
-  if (!((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
-        (input->accel.z == 0.0f))) {
-
-    // 加速度计测量归一化
-    recipNorm = InvSqrt(input->accel.x * input->accel.x +
-                        input->accel.y * input->accel.y +
-                        input->accel.z * input->accel.z);
-    input->accel.x *= recipNorm;
-    input->accel.y *= recipNorm;
-    input->accel.z *= recipNorm;
-
-    // 将磁强计测量归一化
-    recipNorm =
-        InvSqrt(input->mag.x * input->mag.x + input->mag.y * input->mag.y +
-                input->mag.z * input->mag.z);
-    input->mag.x *= recipNorm;
-    input->mag.y *= recipNorm;
-    input->mag.z *= recipNorm;
-
-    // 辅助变量避免重复运算
-    q0q0 = ahrs->filter.q[0] * ahrs->filter.q[0];
-    q0q1 = ahrs->filter.q[0] * ahrs->filter.q[1];
-    q0q2 = ahrs->filter.q[0] * ahrs->filter.q[2];
-    q0q3 = ahrs->filter.q[0] * ahrs->filter.q[3];
-    q1q1 = ahrs->filter.q[1] * ahrs->filter.q[1];
-    q1q2 = ahrs->filter.q[1] * ahrs->filter.q[2];
-    q1q3 = ahrs->filter.q[1] * ahrs->filter.q[3];
-    q2q2 = ahrs->filter.q[2] * ahrs->filter.q[2];
-    q2q3 = ahrs->filter.q[2] * ahrs->filter.q[3];
-    q3q3 = ahrs->filter.q[3] * ahrs->filter.q[3];
-
-    // 地球磁场的参考方向
-    hx = 2.0f * (input->mag.x * (0.5f - q2q2 - q3q3) +
-                 input->mag.y * (q1q2 - q0q3) + input->mag.z * (q1q3 + q0q2));
-    hy = 2.0f *
-         (input->mag.x * (q1q2 + q0q3) + input->mag.y * (0.5f - q1q1 - q3q3) +
-          input->mag.z * (q2q3 - q0q1));
-    bx = sqrtf(hx * hx + hy * hy);
-    bz = 2.0f * (input->mag.x * (q1q3 - q0q2) + input->mag.y * (q2q3 + q0q1) +
-                 input->mag.z * (0.5f - q1q1 - q2q2));
-
-    // 重力和磁场的估计方向
-    halfvx = q1q3 - q0q2;
-    halfvy = q0q1 + q2q3;
-    halfvz = q0q0 - 0.5f + q3q3;
-    halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
-    halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
-    halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
-
-    // 误差是估计方向与测量的场矢量方向之和
-    halfex = (input->accel.x * halfvz - input->accel.z * halfvy) +
-             (input->mag.y * halfwz - input->mag.z * halfwy);
-    halfey = (input->accel.z * halfvx - input->accel.x * halfvz) +
-             (input->mag.z * halfwx - input->mag.x * halfwz);
-    halfez = (input->accel.x * halfvy - input->accel.y * halfvx) +
-             (input->mag.x * halfwy - input->mag.y * halfwx);
+  // 积分反馈留给后续传播步施加
+  MahonyAccumulateIntegral(ahrs, halfe, elapsed);
+
+  // 比例反馈一次性旋转
+  MahonyIntegrate(ahrs, twoKp * halfe[0], twoKp * halfe[1], twoKp * halfe[2],
+                  elapsed);
+}
+
+/**
+ * @brief 每次调用都传播，每correctionDivider次调用修正一次
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,陀螺仪单位°/s，与MahonyUpdateAHRS一致
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
+ */
+void MahonyUpdateDecimated(MahonyFilterType *ahrs, MahonyInput *input,
+                           float dt) {
+  // 与MahonyUpdateAHRS一致，先用本次测量修正，再传播
+  if (++ahrs->correctionCount >= ahrs->config.correctionDivider) {
+    ahrs->correctionCount = 0;
+    MahonyCorrect(ahrs, input);
+  }
+
+  MahonyPropagate(ahrs, input->gyro.x * 0.0174533f,
+                  input->gyro.y * 0.0174533f, input->gyro.z * 0.0174533f, dt);
+}
+
+/**
+ * @brief 计算一次反馈并积分四元数，供MahonyUpdateAHRS/MahonyUpdateAHRSIMU使用
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,陀螺仪单位rad/s
+ * @param useMag 是否使用磁力计
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
+ */
+static void MahonyUpdateCore(MahonyFilterType *ahrs, MahonyInput *input,
+                             uint8_t useMag, float dt) {
+  float halfe[3];
+  float twoKp;
+
+  // 未给出间隔时间则使用配置的计算周期
+  if (dt <= 0.0f) {
+    dt = ahrs->config.samplePeriod;
+  }
 
+  // 仅在加速度计测量有效时计算反馈（避免加速度计归一化中出现 NaN）
+  if (MahonyFeedbackError(ahrs, input, useMag, halfe, &twoKp)) {
     // 如果启用，计算并应用积分反馈
-    if (ahrs->filter.twoKi > 0.0f) {
-      // 按 Ki 缩放的积分误差
-      ahrs->filter.integralFB[0] += ahrs->filter.twoKi * halfex / dt;
-      ahrs->filter.integralFB[1] += ahrs->filter.twoKi * halfey / dt;
-      ahrs->filter.integralFB[2] += ahrs->filter.twoKi * halfez / dt;
-      input->gyro.x += ahrs->filter.integralFB[0]; // 应用积分反馈
-      input->gyro.y += ahrs->filter.integralFB[1];
-      input->gyro.z += ahrs->filter.integralFB[2];
-    } else {
-      ahrs->filter.integralFB[0] = 0.0f; // 防止整体卷绕
-      ahrs->filter.integralFB[1] = 0.0f;
-      ahrs->filter.integralFB[2] = 0.0f;
-    }
+    MahonyAccumulateIntegral(ahrs, halfe, dt);
+    input->gyro.x += ahrs->filter.integralFB[0];
+    input->gyro.y += ahrs->filter.integralFB[1];
+    input->gyro.z += ahrs->filter.integralFB[2];
 
     // 应用比例反馈
-    input->gyro.x += ahrs->filter.twoKp * halfex;
-    input->gyro.y += ahrs->filter.twoKp * halfey;
-    input->gyro.z += ahrs->filter.twoKp * halfez;
+    input->gyro.x += twoKp * halfe[0];
+    input->gyro.y += twoKp * halfe[1];
+    input->gyro.z += twoKp * halfe[2];
   }
 
   // 积分四元数的变化率
-  input->gyro.x *= (0.5f / dt); // 预乘公因数
-  input->gyro.y *= (0.5f / dt);
-  input->gyro.z *= (0.5f / dt);
-  qa = ahrs->filter.q[0];
-  qb = ahrs->filter.q[1];
-  qc = ahrs->filter.q[2];
-  ahrs->filter.q[0] += (-qb * input->gyro.x - qc * input->gyro.y -
-                        ahrs->filter.q[3] * input->gyro.z);
-  ahrs->filter.q[1] += (qa * input->gyro.x + qc * input->gyro.z -
-                        ahrs->filter.q[3] * input->gyro.y);
-  ahrs->filter.q[2] += (qa * input->gyro.y - qb * input->gyro.z +
-                        ahrs->filter.q[3] * input->gyro.x);
-  ahrs->filter.q[3] +=
-      (qa * input->gyro.z + qb * input->gyro.y - qc * input->gyro.x);
+  MahonyIntegrate(ahrs, input->gyro.x, input->gyro.y, input->gyro.z, dt);
+  ahrs->lastUpdateTime += dt;
+}
 
-  // 四元数规范化
-  recipNorm = InvSqrt(ahrs->filter.q[0] * ahrs->filter.q[0] +
-                      ahrs->filter.q[1] * ahrs->filter.q[1] +
-                      ahrs->filter.q[2] * ahrs->filter.q[2] +
-                      ahrs->filter.q[3] * ahrs->filter.q[3]);
-  ahrs->filter.q[0] *= recipNorm;
-  ahrs->filter.q[1] *= recipNorm;
-  ahrs->filter.q[2] *= recipNorm;
-  ahrs->filter.q[3] *= recipNorm;
+/**
+ * @brief 计算估计方向与测量方向的误差(半值)
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,accel与mag会被就地归一化
+ * @param useMag 是否使用磁力计
+ * @param halfe 输出误差[x, y, z]
+ * @param twoKp 输出本次使用的2 * 比例增益
+ * @return uint8_t 加速度计测量无效时返回0
+ */
+static uint8_t MahonyFeedbackError(MahonyFilterType *ahrs, MahonyInput *input,
+                                   uint8_t useMag, float halfe[3],
+                                   float *twoKp) {
+  float recipNorm, accelNormSq;
+  float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  float hx, hy, bx, bz;
+  float halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
+
+  if ((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
+      (input->accel.z == 0.0f)) {
+    return 0;
+  }
+
+  // 加速度计测量归一化
+  accelNormSq = input->accel.x * input->accel.x +
+                input->accel.y * input->accel.y +
+                input->accel.z * input->accel.z;
+  recipNorm = MahonyInvSqrt(accelNormSq);
+  *twoKp = ahrs->filter.twoKp;
+  if (ahrs->config.adaptiveGain) {
+    *twoKp = MahonyAdaptiveTwoKp(ahrs, accelNormSq * recipNorm);
+  }
+  input->accel.x *= recipNorm;
+  input->accel.y *= recipNorm;
+  input->accel.z *= recipNorm;
+
+  // 辅助变量避免重复运算
+  q0q0 = ahrs->filter.q[0] * ahrs->filter.q[0];
+  q0q1 = ahrs->filter.q[0] * ahrs->filter.q[1];
+  q0q2 = ahrs->filter.q[0] * ahrs->filter.q[2];
+  q0q3 = ahrs->filter.q[0] * ahrs->filter.q[3];
+  q1q1 = ahrs->filter.q[1] * ahrs->filter.q[1];
+  q1q2 = ahrs->filter.q[1] * ahrs->filter.q[2];
+  q1q3 = ahrs->filter.q[1] * ahrs->filter.q[3];
+  q2q2 = ahrs->filter.q[2] * ahrs->filter.q[2];
+  q2q3 = ahrs->filter.q[2] * ahrs->filter.q[3];
+  q3q3 = ahrs->filter.q[3] * ahrs->filter.q[3];
+
+  // 估计重力方向
+  halfvx = q1q3 - q0q2;
+  halfvy = q0q1 + q2q3;
+  halfvz = q0q0 - 0.5f + q3q3;
+
+  // 误差是估计重力方向 与测量的重力方向的乘积之和
+  halfe[0] = (input->accel.y * halfvz - input->accel.z * halfvy);
+  halfe[1] = (input->accel.z * halfvx - input->accel.x * halfvz);
+  halfe[2] = (input->accel.x * halfvy - input->accel.y * halfvx);
+
+  if (!useMag) {
+    return 1;
+  }
+
+  // 将磁强计测量归一化
+  recipNorm =
+      MahonyInvSqrt(input->mag.x * input->mag.x + input->mag.y * input->mag.y +
+                    input->mag.z * input->mag.z);
+  input->mag.x *= recipNorm;
+  input->mag.y *= recipNorm;
+  input->mag.z *= recipNorm;
+
+  // 地球磁场的参考方向
+  hx = 2.0f * (input->mag.x * (0.5f - q2q2 - q3q3) +
+               input->mag.y * (q1q2 - q0q3) + input->mag.z * (q1q3 + q0q2));
+  hy = 2.0f *
+       (input->mag.x * (q1q2 + q0q3) + input->mag.y * (0.5f - q1q1 - q3q3) +
+        input->mag.z * (q2q3 - q0q1));
+  bx = sqrtf(hx * hx + hy * hy);
+  bz = 2.0f * (input->mag.x * (q1q3 - q0q2) + input->mag.y * (q2q3 + q0q1) +
+               input->mag.z * (0.5f - q1q1 - q2q2));
+
+  // 磁场的估计方向
+  halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+  halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+  halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+  // 误差是估计方向与测量的场矢量方向之和
+  halfe[0] += (input->mag.y * halfwz - input->mag.z * halfwy);
+  halfe[1] += (input->mag.z * halfwx - input->mag.x * halfwz);
+  halfe[2] += (input->mag.x * halfwy - input->mag.y * halfwx);
+
+  return 1;
 }
 
 /**
- * @brief mahony进行一次计算求得四元数。(当磁力计不可靠时)
+ * @brief 累计积分反馈
  *
  * @param ahrs MahonyFilterType
- * @param input MahonyInput,应放入采集到的姿态数据。
- * @param dt 计算间隔时间
+ * @param halfe 误差[x, y, z]
+ * @param dt 积分时间(s)
  */
-void MahonyUpdateAHRSIMU(MahonyFilterType *ahrs, MahonyInput *input, float dt) {
-  float recipNorm;
-  float halfvx, halfvy, halfvz;
-  float halfex, halfey, halfez;
-  float qa, qb, qc;
+static void MahonyAccumulateIntegral(MahonyFilterType *ahrs,
+                                     const float halfe[3], float dt) {
+  if (ahrs->filter.twoKi > 0.0f) {
+    // 按 Ki 缩放的积分误差
+    ahrs->filter.integralFB[0] += ahrs->filter.twoKi * halfe[0] * dt;
+    ahrs->filter.integralFB[1] += ahrs->filter.twoKi * halfe[1] * dt;
+    ahrs->filter.integralFB[2] += ahrs->filter.twoKi * halfe[2] * dt;
+  } else {
+    ahrs->filter.integralFB[0] = 0.0f; // 防止整体卷绕
+    ahrs->filter.integralFB[1] = 0.0f;
+    ahrs->filter.integralFB[2] = 0.0f;
+  }
+}
 
-  // 仅在加速度计测量有效时计算反馈（避免加速度计归一化中出现 NaN）
-  if (!((input->accel.x == 0.0f) && (input->accel.y == 0.0f) &&
-        (input->accel.z == 0.0f))) {
-
-    // 使加速度计测量归一化
-    recipNorm = InvSqrt(input->accel.x * input->accel.x +
-                        input->accel.y * input->accel.y +
-                        input->accel.z * input->accel.z);
-    input->accel.x *= recipNorm;
-    input->accel.y *= recipNorm;
-    input->accel.z *= recipNorm;
-
-    // 估计重力方向
-    halfvx = ahrs->filter.q[1] * ahrs->filter.q[3] -
-             ahrs->filter.q[0] * ahrs->filter.q[2];
-    halfvy = ahrs->filter.q[0] * ahrs->filter.q[1] +
-             ahrs->filter.q[2] * ahrs->filter.q[3];
-    halfvz = ahrs->filter.q[0] * ahrs->filter.q[0] - 0.5f +
-             ahrs->filter.q[3] * ahrs->filter.q[3];
-
-    // 误差是估计重力方向 与测量的重力方向的乘积之和
-    halfex = (input->accel.y * halfvz - input->accel.z * halfvy);
-    halfey = (input->accel.z * halfvx - input->accel.x * halfvz);
-    halfez = (input->accel.x * halfvy - input->accel.y * halfvx);
+/**
+ * @brief 计算自适应比例增益
+ *
+ * @param ahrs MahonyFilterType
+ * @param accelNorm 本次加速度模长(与config.gravity同单位)
+ * @return float 2 * 本次使用的比例增益
+ * @note 启动阶段Kp由kpBoot线性降至kp以加速收敛；
+ *       加速度模长偏离1g时(存在线加速度)按偏离比例线性降低Kp
+ */
+static float MahonyAdaptiveTwoKp(const MahonyFilterType *ahrs,
+                                 float accelNorm) {
+  const MahonyConfig *cfg = &ahrs->config;
+  float kp = cfg->kp;
+  float deviation;
+
+  // 启动收敛
+  if (ahrs->lastUpdateTime < cfg->bootTime) {
+    kp = cfg->kpBoot +
+         (cfg->kp - cfg->kpBoot) * (ahrs->lastUpdateTime / cfg->bootTime);
+  }
 
-    // 如果启用，计算并应用积分反馈
-    if (ahrs->filter.twoKi > 0.0f) {
-      // 按 Ki 缩放的积分误差
-      ahrs->filter.integralFB[0] += ahrs->filter.twoKi * halfex / dt;
-      ahrs->filter.integralFB[1] += ahrs->filter.twoKi * halfey / dt;
-      ahrs->filter.integralFB[2] += ahrs->filter.twoKi * halfez / dt;
-      input->gyro.x += ahrs->filter.integralFB[0]; // 应用积分反馈
-      input->gyro.y += ahrs->filter.integralFB[1];
-      input->gyro.z += ahrs->filter.integralFB[2];
-    } else {
-      ahrs->filter.integralFB[0] = 0.0f; // 防止整体卷绕
-      ahrs->filter.integralFB[1] = 0.0f;
-      ahrs->filter.integralFB[2] = 0.0f;
+  // 线加速度抑制
+  if (cfg->accelTolerance > 0.0f) {
+    deviation = accelNorm / cfg->gravity - 1.0f;
+    if (deviation < 0.0f) {
+      deviation = -deviation;
     }
+    if (deviation >= cfg->accelTolerance) {
+      return 0.0f;
+    }
+    kp *= 1.0f - deviation / cfg->accelTolerance;
+  }
 
-    // 应用比例反馈
-    input->gyro.x += ahrs->filter.twoKp * halfex;
-    input->gyro.y += ahrs->filter.twoKp * halfey;
-    input->gyro.z += ahrs->filter.twoKp * halfez;
+  return 2.0f * kp;
+}
+
+/**
+ * @brief 按修正后的角速度积分四元数并规范化
+ *
+ * @param ahrs MahonyFilterType
+ * @param gx 角速度x(rad/s)
+ * @param gy 角速度y(rad/s)
+ * @param gz 角速度z(rad/s)
+ * @param dt 计算间隔时间(s)
+ * @note 角速度在dt内视为常量，q = q * dq，dq = exp([0, w*dt/2])
+ *       EULER: dq = [1, h]，一阶
+ *       RK2:   dq = [1 - |h|²/2, h]，二阶，与常角速度下的中点法等价
+ *       EXP:   dq = [cos|h|, sin|h| * h/|h|]，精确，适合大角度步长
+ */
+static void MahonyIntegrate(MahonyFilterType *ahrs, float gx, float gy,
+                            float gz, float dt) {
+  float recipNorm;
+  float qa, qb, qc, qd;
+  float d0;
+  float hx = gx * (0.5f * dt); // 预乘公因数
+  float hy = gy * (0.5f * dt);
+  float hz = gz * (0.5f * dt);
+
+#if (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_EULER)
+  d0 = 1.0f;
+#elif (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_RK2)
+  d0 = 1.0f - 0.5f * (hx * hx + hy * hy + hz * hz);
+#elif (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_EXP)
+  float theta2 = hx * hx + hy * hy + hz * hz;
+  float k;
+
+  if (theta2 < 1e-8f) {
+    // 小角度时用泰勒展开，避免除零
+    d0 = 1.0f - 0.5f * theta2;
+    k = 1.0f - theta2 * (1.0f / 6.0f);
+  } else {
+    float theta = sqrtf(theta2);
+    d0 = cosf(theta);
+    k = sinf(theta) / theta;
   }
+  hx *= k;
+  hy *= k;
+  hz *= k;
+#else
+#error "unknown MAHONY_INTEGRATOR"
+#endif
 
-  // 积分四元数的变化率
-  input->gyro.x *= (0.5f / dt); // 预乘公因数
-  input->gyro.y *= (0.5f / dt);
-  input->gyro.z *= (0.5f / dt);
   qa = ahrs->filter.q[0];
   qb = ahrs->filter.q[1];
   qc = ahrs->filter.q[2];
-  ahrs->filter.q[0] += (-qb * input->gyro.x - qc * input->gyro.y -
-                        ahrs->filter.q[3] * input->gyro.z);
-  ahrs->filter.q[1] += (qa * input->gyro.x + qc * input->gyro.z -
-                        ahrs->filter.q[3] * input->gyro.y);
-  ahrs->filter.q[2] += (qa * input->gyro.y - qb * input->gyro.z +
-                        ahrs->filter.q[3] * input->gyro.x);
-  ahrs->filter.q[3] +=
-      (qa * input->gyro.z + qb * input->gyro.y - qc * input->gyro.x);
+  qd = ahrs->filter.q[3];
+  ahrs->filter.q[0] = qa * d0 - qb * hx - qc * hy - qd * hz;
+  ahrs->filter.q[1] = qb * d0 + qa * hx + qc * hz - qd * hy;
+  ahrs->filter.q[2] = qc * d0 + qa * hy - qb * hz + qd * hx;
+  ahrs->filter.q[3] = qd * d0 + qa * hz + qb * hy - qc * hx;
 
   // 四元数规范化
-  recipNorm = InvSqrt(ahrs->filter.q[0] * ahrs->filter.q[0] +
-                      ahrs->filter.q[1] * ahrs->filter.q[1] +
-                      ahrs->filter.q[2] * ahrs->filter.q[2] +
-                      ahrs->filter.q[3] * ahrs->filter.q[3]);
+  recipNorm = MahonyInvSqrt(ahrs->filter.q[0] * ahrs->filter.q[0] +
+                            ahrs->filter.q[1] * ahrs->filter.q[1] +
+                            ahrs->filter.q[2] * ahrs->filter.q[2] +
+                            ahrs->filter.q[3] * ahrs->filter.q[3]);
   ahrs->filter.q[0] *= recipNorm;
   ahrs->filter.q[1] *= recipNorm;
   ahrs->filter.q[2] *= recipNorm;
   ahrs->filter.q[3] *= recipNorm;
+
+  // 四元数已变化，姿态输出缓存失效
+  ahrs->cacheValid = 0;
 }
 
 /**
- * @brief 快速平方根倒数算法
+ * @brief 平方根倒数，实现由MAHONY_INVSQRT_KERNEL在编译期选择
  * @param  x               要求算的数字
  * @return float
+ * @note HW: 精度最高，M4F上约14周期;
+ *       NEWTON: 相对误差约1.8e-3，用uint32_t做位运算，LP64主机上同样正确;
+ *       SSE: rsqrtss(12bit)再迭代一次，相对误差约2e-7，仅主机仿真使用
  */
-float InvSqrt(float x) {
-  float halfx = 0.5f * x;
-  union {
-    float f;
-    long l;
-  } i;
-  i.f = x;
-  i.l = 0x5f3759df - (i.l >> 1);
-  float y = i.f;
-  y = y * (1.5f - (halfx * y * y));
-  y = y * (1.5f - (halfx * y * y));
-  return y;
+float MahonyInvSqrt(float x) {
+#if (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_HW)
+  return 1.0f / sqrtf(x);
+#elif (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_NEWTON)
+  float y;
+  uint32_t i;
+
+  memcpy(&i, &x, sizeof(i)); // 按位取出，避免long在64位平台上的错误
+  i = 0x5f375a86u - (i >> 1);
+  memcpy(&y, &i, sizeof(y));
+  return y * (1.5f - (0.5f * x * y * y));
+#elif (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_SSE)
+  float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+  return y * (1.5f - (0.5f * x * y * y));
+#else
+#error "unknown MAHONY_INVSQRT_KERNEL"
+#endif
 }
 
 /**
- * @brief 使用Mahony算法解算欧拉角(FRD载体系)
- * @param  mpu6050          指向mpu6050_struct的地址，用于读取数据。
- * @param  ist8310          指向ist8310_struct的地址，用于读取数据。
- * @param  filter           指向MahonyFilterType的地址，用于数据计算。
- * @param  mahony           指向MahonyType的地址，用于存储计算结果。
+ * @brief 使用Mahony算法更新一次并解算欧拉角(FRD载体系与NED导航系)
+ *
+ * @param ahrs MahonyFilterType
+ * @param input MahonyInput,应放入采集到的姿态数据。
+ * @param dt 计算间隔时间(s)，<=0时使用config.samplePeriod
+ * @note 结果存于ahrs->frd与ahrs->ned；只需姿态时可直接调用MahonyGetFRD
  */
 void MahonyGetEuler(MahonyFilterType *ahrs, MahonyInput *input, float dt) {
-
   MahonyUpdateAHRS(ahrs, input, dt);
+  MahonyGetFRD(ahrs);
+}
+
+/**
+ * @brief 获取FRD载体系欧拉角，四元数未更新时直接返回缓存
+ *
+ * @param ahrs MahonyFilterType
+ * @return const FRDEulerAngle* 角度值与弧度值，航向角范围[0, 360)
+ */
+const FRDEulerAngle *MahonyGetFRD(MahonyFilterType *ahrs) {
+  if (ahrs->cacheValid & MAHONY_CACHE_EULER) {
+    return &ahrs->frd;
+  }
+
+  MahonyQuaternionToFRD(ahrs->filter.q, &ahrs->frd);
+
+  // 导航系Z轴朝上，转为北东地需绕X轴旋转180°：俯仰、航向取反
+  ahrs->ned.roll = ahrs->frd.roll;
+  ahrs->ned.pitch = -ahrs->frd.pitch;
+  ahrs->ned.yaw = fmodf(360.0f - ahrs->frd.yaw, 360.0f);
+
+  ahrs->cacheValid |= MAHONY_CACHE_EULER;
+  return &ahrs->frd;
+}
+
+/**
+ * @brief 由四元数求FRD欧拉角
+ *
+ * @param q 四元数[q0, q1, q2, q3]
+ * @param frd 输出角度值与弧度值，航向角范围[0, 360)
+ * @note 角度值保留小数；旧版MahonyGetEuler向下取整为整数度，需要整数时由调用者floorf
+ */
+void MahonyQuaternionToFRD(const float q[4], FRDEulerAngle *frd) {
+  float sinp = -2.0f * (q[1] * q[3] - q[0] * q[2]);
+
+  // 数值误差可能使|sinp|略大于1，限幅避免asinf得到NaN
+  if (sinp > 1.0f) {
+    sinp = 1.0f;
+  } else if (sinp < -1.0f) {
+    sinp = -1.0f;
+  }
+
   // 四元数结算弧度
-  ahrs->frd.rollRad = atan2f(ahrs->filter.q[0] * ahrs->filter.q[1] +
-                                 ahrs->filter.q[2] * ahrs->filter.q[3],
-                             0.5f - ahrs->filter.q[1] * ahrs->filter.q[1] -
-                                 ahrs->filter.q[2] * ahrs->filter.q[2]);
-  ahrs->frd.pitchRad = asinf(-2.0f * (ahrs->filter.q[1] * ahrs->filter.q[3] -
-                                      ahrs->filter.q[0] * ahrs->filter.q[2]));
-  ahrs->frd.yawRad = atan2f(ahrs->filter.q[1] * ahrs->filter.q[2] +
-                                ahrs->filter.q[0] * ahrs->filter.q[3],
-                            0.5f - ahrs->filter.q[2] * ahrs->filter.q[2] -
-                                ahrs->filter.q[3] * ahrs->filter.q[3]);
+  frd->rollRad =
+      atan2f(q[0] * q[1] + q[2] * q[3], 0.5f - q[1] * q[1] - q[2] * q[2]);
+  frd->pitchRad = asinf(sinp);
+  frd->yawRad =
+      atan2f(q[1] * q[2] + q[0] * q[3], 0.5f - q[2] * q[2] - q[3] * q[3]);
+
   // 弧度转角度
-  ahrs->frd.roll = ahrs->frd.rollRad * 57.29578f;
-  ahrs->frd.pitch = ahrs->frd.pitchRad * 57.29578f;
-  ahrs->frd.yaw = ahrs->frd.yawRad * 57.29578f;
+  frd->roll = frd->rollRad * 57.29578f;
+  frd->pitch = frd->pitchRad * 57.29578f;
+  frd->yaw = frd->yawRad * 57.29578f;
+
+  // 限制航向角0-360°，极小的负值加360后舍入为360，归到0
+  if (frd->yaw < 0.0f) {
+    frd->yaw += 360.0f;
+  }
+  if (frd->yaw >= 360.0f) {
+    frd->yaw = 0.0f;
+  }
+}
+
+/**
+ * @brief 获取NED导航系欧拉角，四元数未更新时直接返回缓存
+ *
+ * @param ahrs MahonyFilterType
+ * @return const NEDEulerAngle* 角度值，航向角范围[0, 360)
+ */
+const NEDEulerAngle *MahonyGetNED(MahonyFilterType *ahrs) {
+  MahonyGetFRD(ahrs);
+  return &ahrs->ned;
+}
 
-  // 限制航向角0-360°
-  if (ahrs->frd.yaw < 0.0f) {
-    ahrs->frd.yaw += 180.0f;
+/**
+ * @brief 获取旋转矩阵(载体系->导航系)，四元数未更新时直接返回缓存
+ *
+ * @param ahrs MahonyFilterType
+ * @return const float(*)[3] 3x3行主序矩阵，v_nav = R * v_body
+ */
+const float (*MahonyGetRotationMatrix(MahonyFilterType *ahrs))[3] {
+  if (ahrs->cacheValid & MAHONY_CACHE_DCM) {
+    return (const float(*)[3])ahrs->dcm;
   }
 
-  // 只保留整数
-  ahrs->frd.roll = floor(ahrs->frd.roll);
-  ahrs->frd.pitch = floor(ahrs->frd.pitch);
-  ahrs->frd.yaw = floor(ahrs->frd.yaw);
+  float q0 = ahrs->filter.q[0], q1 = ahrs->filter.q[1];
+  float q2 = ahrs->filter.q[2], q3 = ahrs->filter.q[3];
+  float q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+  float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+  float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+  ahrs->dcm[0][0] = 1.0f - 2.0f * (q2q2 + q3q3);
+  ahrs->dcm[0][1] = 2.0f * (q1q2 - q0q3);
+  ahrs->dcm[0][2] = 2.0f * (q1q3 + q0q2);
+  ahrs->dcm[1][0] = 2.0f * (q1q2 + q0q3);
+  ahrs->dcm[1][1] = 1.0f - 2.0f * (q1q1 + q3q3);
+  ahrs->dcm[1][2] = 2.0f * (q2q3 - q0q1);
+  ahrs->dcm[2][0] = 2.0f * (q1q3 - q0q2);
+  ahrs->dcm[2][1] = 2.0f * (q2q3 + q0q1);
+  ahrs->dcm[2][2] = 1.0f - 2.0f * (q1q1 + q2q2);
+
+  ahrs->cacheValid |= MAHONY_CACHE_DCM;
+  return (const float(*)[3])ahrs->dcm;
+}
+
+/**
+ * @brief 拷贝当前四元数
+ *
+ * @param ahrs MahonyFilterType
+ * @param q 输出[q0, q1, q2, q3]
+ */
+void MahonyGetQuaternion(const MahonyFilterType *ahrs, float q[4]) {
+  q[0] = ahrs->filter.q[0];
+  q[1] = ahrs->filter.q[1];
+  q[2] = ahrs->filter.q[2];
+  q[3] = ahrs->filter.q[3];
 }
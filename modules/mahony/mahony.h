@@ -3,15 +3,33 @@
 
 #include <stdint.h>
 
-/*前右下坐标系(Euler-FRD)*/
+/*平方根倒数内核选择(编译期)*/
+#define MAHONY_INVSQRT_HW 0     // 硬件开方 1.0f/sqrtf(x)，M4F上为vsqrt.f32+vdiv.f32
+#define MAHONY_INVSQRT_NEWTON 1 // 位运算初值+一次牛顿迭代，适用于无FPU开方指令的内核
+#define MAHONY_INVSQRT_SSE 2    // x86 SSE rsqrtss+一次牛顿迭代，用于主机仿真
+
+#ifndef MAHONY_INVSQRT_KERNEL
+#define MAHONY_INVSQRT_KERNEL MAHONY_INVSQRT_HW
+#endif
+
+/*四元数积分方法选择(编译期)*/
+#define MAHONY_INTEGRATOR_EULER 0 // 一阶，最省
+#define MAHONY_INTEGRATOR_RK2 1   // 二阶，低采样率时推荐
+#define MAHONY_INTEGRATOR_EXP 2   // 四元数指数映射，精确，多一次sqrtf/sinf/cosf
+
+#ifndef MAHONY_INTEGRATOR
+#define MAHONY_INTEGRATOR MAHONY_INTEGRATOR_EULER
+#endif
+
+/*前右下坐标系(Euler-FRD)，角度值不再取整(旧版向下取整为整数度)*/
 typedef struct {
-  float pitch, roll, yaw;          // 角度值
-  float pitchRad, rollRad, yawRad; // 弧度值
+  float pitch, roll, yaw;          // 角度值，航向角[0, 360)
+  float pitchRad, rollRad, yawRad; // 弧度值，航向角(-pi, pi]
 } FRDEulerAngle;
 
-/*北东地坐标系(Euler-NED)*/
+/*北东地坐标系(Euler-NED)，由FRD绕X轴旋转180°: 俯仰取反，航向为(360 - FRD航向) mod 360*/
 typedef struct {
-  float pitch, roll, yaw;
+  float pitch, roll, yaw; // 角度值，航向角[0, 360)
 } NEDEulerAngle;
 
 /*Mahony滤波器核心*/
@@ -23,14 +41,51 @@ typedef struct {
   uint8_t initialized; // 状态标志
 } MahonyFilterCore;
 
+/*mahony初始化配置*/
+typedef struct {
+  float kp;                // 比例增益
+  float ki;                // 积分增益
+  float samplePeriod;      // 计算周期(s)，更新时传入dt<=0则使用该值
+  uint8_t useMagnetometer; // 是否使用磁力计，0时忽略mag，1时mag非全0才使用
+  uint8_t correctionDivider; // MahonyUpdateDecimated每多少次传播修正一次，>=1
+  /*自适应增益，adaptiveGain为0时以下配置无效*/
+  uint8_t adaptiveGain; // 是否启用自适应Kp
+  float kpBoot;         // 启动收敛阶段的比例增益
+  float bootTime;       // 启动收敛时长(s)，期间Kp由kpBoot线性过渡到kp
+  float gravity;        // 重力加速度模长，与输入加速度同单位
+  float accelTolerance; // 加速度模长相对1g的偏离上限，偏离越大Kp越小，超出则为0
+} MahonyConfig;
+
+/*默认配置，与原先硬编码增益一致*/
+#define MAHONY_DEFAULT_CONFIG                                                  \
+  {                                                                            \
+      .kp = 4.3f,                                                              \
+      .ki = 0.1f,                                                              \
+      .samplePeriod = 0.001f,                                                  \
+      .useMagnetometer = 1,                                                    \
+      .correctionDivider = 1,                                                  \
+      .adaptiveGain = 0,                                                       \
+      .kpBoot = 20.0f,                                                         \
+      .bootTime = 2.0f,                                                        \
+      .gravity = 9.8f,                                                         \
+      .accelTolerance = 0.2f,                                                  \
+  }
+
+/*姿态输出缓存标志，四元数更新后全部失效，按需计算*/
+#define MAHONY_CACHE_EULER 0x01 // frd/ned欧拉角已是最新
+#define MAHONY_CACHE_DCM 0x02   // 旋转矩阵已是最新
+
 /*mahony解算器数据类型*/
 typedef struct MahonyFilter {
   MahonyFilterCore filter;
   FRDEulerAngle frd;       // 载体系
   NEDEulerAngle ned;       // 导航系
-  float samplePeriod;      // 计算周期
-  uint8_t useMagnetometer; // 是否使用磁力计
-  float lastUpdateTime;    // 最后更新时间
+  float dcm[3][3];         // 旋转矩阵(载体系->导航系)
+  uint8_t cacheValid;      // 姿态输出缓存标志
+  MahonyConfig config;     // 当前配置，唯一来源；kp/ki经MahonySetGains修改，其余可直接改
+  float lastUpdateTime;    // 最后更新时间(自初始化起累计运行时间,s)
+  float correctionElapsed; // 距上次修正的累计传播时间(s)
+  uint8_t correctionCount; // 降频修正计数
 } MahonyFilterType;
 
 /*传入数据接口*/
@@ -53,7 +108,32 @@ typedef struct {
 /*函数声明*/
 
 void MahonyFilterCoreInit(MahonyFilterType *ahrs);
+void MahonyFilterInit(MahonyFilterType *ahrs, const MahonyConfig *config);
+void MahonySetGains(MahonyFilterType *ahrs, float kp, float ki);
 void MahonyUpdateAHRSIMU(MahonyFilterType *ahrs, MahonyInput *input, float dt);
 void MahonyUpdateAHRS(MahonyFilterType *ahrs, MahonyInput *input, float dt);
+void MahonyPropagate(MahonyFilterType *ahrs, float gx, float gy, float gz,
+                     float dt);
+void MahonyCorrect(MahonyFilterType *ahrs, MahonyInput *input);
+void MahonyUpdateDecimated(MahonyFilterType *ahrs, MahonyInput *input,
+                           float dt);
+float MahonyInvSqrt(float x);
+
+void MahonyGetEuler(MahonyFilterType *ahrs, MahonyInput *input, float dt);
+const FRDEulerAngle *MahonyGetFRD(MahonyFilterType *ahrs);
+const NEDEulerAngle *MahonyGetNED(MahonyFilterType *ahrs);
+const float (*MahonyGetRotationMatrix(MahonyFilterType *ahrs))[3];
+void MahonyGetQuaternion(const MahonyFilterType *ahrs, float q[4]);
+void MahonyQuaternionToFRD(const float q[4], FRDEulerAngle *frd);
+
+/**
+ * @brief 只读访问四元数状态，不拷贝
+ *
+ * @param ahrs MahonyFilterType
+ * @return const float* [q0, q1, q2, q3]
+ */
+static inline const float *MahonyQuaternion(const MahonyFilterType *ahrs) {
+  return ahrs->filter.q;
+}
 
 #endif // !MAHONY_H
@@ -0,0 +1,259 @@
+#include "mahony_array.h"
+#include <math.h>
+
+/**
+ * @brief 初始化多实例mahony解算器，所有通道使用同一配置
+ *
+ * @param arr MahonyArrayType
+ * @param count 滤波器数量，超出MAHONY_ARRAY_MAX时截断
+ * @param config 增益配置，只使用kp与ki
+ */
+void MahonyArrayInit(MahonyArrayType *arr, uint8_t count,
+                     const MahonyConfig *config) {
+  uint8_t i;
+
+  if (count > MAHONY_ARRAY_MAX) {
+    count = MAHONY_ARRAY_MAX;
+  }
+  arr->count = count;
+
+  // 未使用的通道同样初始化，保证整组计算不产生NaN
+  for (i = 0; i < MAHONY_ARRAY_MAX; i++) {
+    arr->q0[i] = 1.0f;
+    arr->q1[i] = 0.0f;
+    arr->q2[i] = 0.0f;
+    arr->q3[i] = 0.0f;
+    arr->ix[i] = 0.0f;
+    arr->iy[i] = 0.0f;
+    arr->iz[i] = 0.0f;
+    MahonyArraySetGains(arr, i, config->kp, config->ki);
+  }
+}
+
+/**
+ * @brief 修改单个通道的增益
+ *
+ * @param arr MahonyArrayType
+ * @param idx 通道号
+ * @param kp 比例增益
+ * @param ki 积分增益
+ */
+void MahonyArraySetGains(MahonyArrayType *arr, uint8_t idx, float kp,
+                         float ki) {
+  arr->twoKp[idx] = 2.0f * kp;
+  arr->twoKi[idx] = 2.0f * ki;
+}
+
+/**
+ * @brief 将单个IMU的数据填入多实例输入
+ *
+ * @param in MahonyArrayInput
+ * @param idx 通道号
+ * @param input MahonyInput,陀螺仪单位需为rad/s
+ */
+void MahonyArraySetInput(MahonyArrayInput *in, uint8_t idx,
+                         const MahonyInput *input) {
+  in->ax[idx] = input->accel.x;
+  in->ay[idx] = input->accel.y;
+  in->az[idx] = input->accel.z;
+  in->gx[idx] = input->gyro.x;
+  in->gy[idx] = input->gyro.y;
+  in->gz[idx] = input->gyro.z;
+  in->mx[idx] = input->mag.x;
+  in->my[idx] = input->mag.y;
+  in->mz[idx] = input->mag.z;
+}
+
+/**
+ * @brief 所有通道同步进行一次加速度计+磁力计解算
+ *
+ * @param arr MahonyArrayType
+ * @param in MahonyArrayInput，mag全0的通道只用加速度计，accel全0的通道只积分陀螺仪
+ * @param dt 计算间隔时间(s)
+ * @note 循环体内没有分支与函数调用，有效性判断改为0/1掩码相乘，
+ *       便于编译器按通道向量化(需-O3与-fno-math-errno或等效选项)。
+ *       积分方法固定为一阶，与MahonyUpdateAHRS默认配置一致。
+ */
+void MahonyArrayUpdateAHRS(MahonyArrayType *arr,
+                           const MahonyArrayInput *restrict in,
+                           float dt) {
+  float *restrict q0 = arr->q0, *restrict q1 = arr->q1;
+  float *restrict q2 = arr->q2, *restrict q3 = arr->q3;
+  float *restrict ix = arr->ix, *restrict iy = arr->iy, *restrict iz = arr->iz;
+  const float *restrict twoKp = arr->twoKp, *restrict twoKi = arr->twoKi;
+  float halfDt = 0.5f * dt;
+  uint8_t i, n = arr->count;
+
+  for (i = 0; i < n; i++) {
+    float a0 = q0[i], a1 = q1[i], a2 = q2[i], a3 = q3[i];
+    float ax = in->ax[i], ay = in->ay[i], az = in->az[i];
+    float mx = in->mx[i], my = in->my[i], mz = in->mz[i];
+    float gx = in->gx[i], gy = in->gy[i], gz = in->gz[i];
+
+    // 有效性掩码
+    float aNormSq = ax * ax + ay * ay + az * az;
+    float mNormSq = mx * mx + my * my + mz * mz;
+    float aValid = (aNormSq > 0.0f) ? 1.0f : 0.0f;
+    float mValid = (mNormSq > 0.0f) ? aValid : 0.0f;
+
+    // 测量归一化，无效时分母加1避免除零
+    float aRecip = 1.0f / sqrtf(aNormSq + (1.0f - aValid));
+    float mRecip = 1.0f / sqrtf(mNormSq + (1.0f - mValid));
+    ax *= aRecip;
+    ay *= aRecip;
+    az *= aRecip;
+    mx *= mRecip;
+    my *= mRecip;
+    mz *= mRecip;
+
+    // 辅助变量避免重复运算
+    float q0q0 = a0 * a0, q0q1 = a0 * a1, q0q2 = a0 * a2, q0q3 = a0 * a3;
+    float q1q1 = a1 * a1, q1q2 = a1 * a2, q1q3 = a1 * a3;
+    float q2q2 = a2 * a2, q2q3 = a2 * a3, q3q3 = a3 * a3;
+
+    // 地球磁场的参考方向
+    float hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) +
+                       mz * (q1q3 + q0q2));
+    float hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) +
+                       mz * (q2q3 - q0q1));
+    float bx = sqrtf(hx * hx + hy * hy);
+    float bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) +
+                       mz * (0.5f - q1q1 - q2q2));
+
+    // 重力和磁场的估计方向
+    float halfvx = q1q3 - q0q2;
+    float halfvy = q0q1 + q2q3;
+    float halfvz = q0q0 - 0.5f + q3q3;
+    float halfwx = bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+    float halfwy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+    float halfwz = bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2);
+
+    // 误差，按掩码屏蔽无效测量
+    float ex = aValid * (ay * halfvz - az * halfvy) +
+               mValid * (my * halfwz - mz * halfwy);
+    float ey = aValid * (az * halfvx - ax * halfvz) +
+               mValid * (mz * halfwx - mx * halfwz);
+    float ez = aValid * (ax * halfvy - ay * halfvx) +
+               mValid * (mx * halfwy - my * halfwx);
+
+    // 积分反馈，Ki为0时清零
+    float kiOn = (twoKi[i] > 0.0f) ? 1.0f : 0.0f;
+    ix[i] = kiOn * (ix[i] + twoKi[i] * ex * dt);
+    iy[i] = kiOn * (iy[i] + twoKi[i] * ey * dt);
+    iz[i] = kiOn * (iz[i] + twoKi[i] * ez * dt);
+
+    // 应用积分与比例反馈
+    gx = (gx + aValid * ix[i] + twoKp[i] * ex) * halfDt;
+    gy = (gy + aValid * iy[i] + twoKp[i] * ey) * halfDt;
+    gz = (gz + aValid * iz[i] + twoKp[i] * ez) * halfDt;
+
+    // 积分四元数
+    float n0 = a0 - a1 * gx - a2 * gy - a3 * gz;
+    float n1 = a1 + a0 * gx + a2 * gz - a3 * gy;
+    float n2 = a2 + a0 * gy - a1 * gz + a3 * gx;
+    float n3 = a3 + a0 * gz + a1 * gy - a2 * gx;
+
+    // 四元数规范化
+    float recipNorm = 1.0f / sqrtf(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+    q0[i] = n0 * recipNorm;
+    q1[i] = n1 * recipNorm;
+    q2[i] = n2 * recipNorm;
+    q3[i] = n3 * recipNorm;
+  }
+}
+
+/**
+ * @brief 所有通道同步进行一次纯IMU解算(不使用磁力计)
+ *
+ * @param arr MahonyArrayType
+ * @param in MahonyArrayInput，mag字段不读取
+ * @param dt 计算间隔时间(s)
+ */
+void MahonyArrayUpdateAHRSIMU(MahonyArrayType *arr,
+                              const MahonyArrayInput *restrict in,
+                              float dt) {
+  float *restrict q0 = arr->q0, *restrict q1 = arr->q1;
+  float *restrict q2 = arr->q2, *restrict q3 = arr->q3;
+  float *restrict ix = arr->ix, *restrict iy = arr->iy, *restrict iz = arr->iz;
+  const float *restrict twoKp = arr->twoKp, *restrict twoKi = arr->twoKi;
+  float halfDt = 0.5f * dt;
+  uint8_t i, n = arr->count;
+
+  for (i = 0; i < n; i++) {
+    float a0 = q0[i], a1 = q1[i], a2 = q2[i], a3 = q3[i];
+    float ax = in->ax[i], ay = in->ay[i], az = in->az[i];
+    float gx = in->gx[i], gy = in->gy[i], gz = in->gz[i];
+
+    // 有效性掩码与归一化
+    float aNormSq = ax * ax + ay * ay + az * az;
+    float aValid = (aNormSq > 0.0f) ? 1.0f : 0.0f;
+    float aRecip = 1.0f / sqrtf(aNormSq + (1.0f - aValid));
+    ax *= aRecip;
+    ay *= aRecip;
+    az *= aRecip;
+
+    // 估计重力方向
+    float halfvx = a1 * a3 - a0 * a2;
+    float halfvy = a0 * a1 + a2 * a3;
+    float halfvz = a0 * a0 - 0.5f + a3 * a3;
+
+    // 误差是估计重力方向与测量的重力方向的乘积之和
+    float ex = aValid * (ay * halfvz - az * halfvy);
+    float ey = aValid * (az * halfvx - ax * halfvz);
+    float ez = aValid * (ax * halfvy - ay * halfvx);
+
+    // 积分反馈，Ki为0时清零
+    float kiOn = (twoKi[i] > 0.0f) ? 1.0f : 0.0f;
+    ix[i] = kiOn * (ix[i] + twoKi[i] * ex * dt);
+    iy[i] = kiOn * (iy[i] + twoKi[i] * ey * dt);
+    iz[i] = kiOn * (iz[i] + twoKi[i] * ez * dt);
+
+    // 应用积分与比例反馈
+    gx = (gx + aValid * ix[i] + twoKp[i] * ex) * halfDt;
+    gy = (gy + aValid * iy[i] + twoKp[i] * ey) * halfDt;
+    gz = (gz + aValid * iz[i] + twoKp[i] * ez) * halfDt;
+
+    // 积分四元数
+    float n0 = a0 - a1 * gx - a2 * gy - a3 * gz;
+    float n1 = a1 + a0 * gx + a2 * gz - a3 * gy;
+    float n2 = a2 + a0 * gy - a1 * gz + a3 * gx;
+    float n3 = a3 + a0 * gz + a1 * gy - a2 * gx;
+
+    // 四元数规范化
+    float recipNorm = 1.0f / sqrtf(n0 * n0 + n1 * n1 + n2 * n2 + n3 * n3);
+    q0[i] = n0 * recipNorm;
+    q1[i] = n1 * recipNorm;
+    q2[i] = n2 * recipNorm;
+    q3[i] = n3 * recipNorm;
+  }
+}
+
+/**
+ * @brief 拷贝单个通道的四元数
+ *
+ * @param arr MahonyArrayType
+ * @param idx 通道号
+ * @param q 输出[q0, q1, q2, q3]
+ */
+void MahonyArrayGetQuaternion(const MahonyArrayType *arr, uint8_t idx,
+                              float q[4]) {
+  q[0] = arr->q0[idx];
+  q[1] = arr->q1[idx];
+  q[2] = arr->q2[idx];
+  q[3] = arr->q3[idx];
+}
+
+/**
+ * @brief 求单个通道的FRD欧拉角
+ *
+ * @param arr MahonyArrayType
+ * @param idx 通道号
+ * @param frd 输出角度值与弧度值，航向角范围[0, 360)
+ */
+void MahonyArrayGetFRD(const MahonyArrayType *arr, uint8_t idx,
+                       FRDEulerAngle *frd) {
+  float q[4];
+
+  MahonyArrayGetQuaternion(arr, idx, q);
+  MahonyQuaternionToFRD(q, frd);
+}
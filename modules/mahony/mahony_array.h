@@ -0,0 +1,50 @@
+#ifndef MAHONY_ARRAY_H
+#define MAHONY_ARRAY_H
+
+#include <stdint.h>
+
+#include "mahony.h"
+
+/*同时解算的滤波器数量上限，按IMU数量配置*/
+#ifndef MAHONY_ARRAY_MAX
+#define MAHONY_ARRAY_MAX 8
+#endif
+
+/*多实例mahony解算器，结构体数组(SoA)布局，N个滤波器同步更新*/
+typedef struct {
+  float q0[MAHONY_ARRAY_MAX]; // 四元数状态，按分量分组
+  float q1[MAHONY_ARRAY_MAX];
+  float q2[MAHONY_ARRAY_MAX];
+  float q3[MAHONY_ARRAY_MAX];
+  float ix[MAHONY_ARRAY_MAX]; // 积分误差项
+  float iy[MAHONY_ARRAY_MAX];
+  float iz[MAHONY_ARRAY_MAX];
+  float twoKp[MAHONY_ARRAY_MAX]; // 2 * 比例增益
+  float twoKi[MAHONY_ARRAY_MAX]; // 2 * 积分增益
+  uint8_t count;                 // 实际使用的滤波器数量
+} MahonyArrayType;
+
+/*多实例传入数据，按轴分组；陀螺仪单位rad/s，mag全0的通道只用加速度计*/
+typedef struct {
+  float ax[MAHONY_ARRAY_MAX], ay[MAHONY_ARRAY_MAX], az[MAHONY_ARRAY_MAX];
+  float gx[MAHONY_ARRAY_MAX], gy[MAHONY_ARRAY_MAX], gz[MAHONY_ARRAY_MAX];
+  float mx[MAHONY_ARRAY_MAX], my[MAHONY_ARRAY_MAX], mz[MAHONY_ARRAY_MAX];
+} MahonyArrayInput;
+
+/*函数声明*/
+
+void MahonyArrayInit(MahonyArrayType *arr, uint8_t count,
+                     const MahonyConfig *config);
+void MahonyArraySetGains(MahonyArrayType *arr, uint8_t idx, float kp, float ki);
+void MahonyArraySetInput(MahonyArrayInput *in, uint8_t idx,
+                         const MahonyInput *input);
+void MahonyArrayUpdateAHRS(MahonyArrayType *arr, const MahonyArrayInput *in,
+                           float dt);
+void MahonyArrayUpdateAHRSIMU(MahonyArrayType *arr, const MahonyArrayInput *in,
+                              float dt);
+void MahonyArrayGetQuaternion(const MahonyArrayType *arr, uint8_t idx,
+                              float q[4]);
+void MahonyArrayGetFRD(const MahonyArrayType *arr, uint8_t idx,
+                       FRDEulerAngle *frd);
+
+#endif // !MAHONY_ARRAY_H
@@ -1,6 +1,12 @@
 #include "pid.h"
 #include <math.h>
 
+static void PIDClampIntegral(PIDControllerCore *core); // 积分限幅
+static float PIDClampOutput(PIDControllerCore *core, float out); // 输出限幅
+static void PIDOutput(PIDControllerType *pid, float error, float pd,
+                      float dt); // 积分、抗饱和与输出限制
+static int16_t PIDQ15Gain(float gain, uint8_t shift); // 浮点系数转Q15
+
 /**
  * @brief 初始化pid控制器
  * @param  pid pid环
@@ -17,6 +23,88 @@ void PID_Init(PIDControllerType *pid, float kp, float ki, float kd,
   pid->core.integral = 0.0f;
   pid->core.prev_error = 0.0f;
   pid->core.output_limit = limit;
+
+  // 设定值/测量值分离模式默认: 比例项全权重，微分只作用于测量值，不滤波
+  pid->core.beta = 1.0f;
+  pid->core.gamma = 0.0f;
+  pid->core.d_cutoff = 0.0f;
+  pid->core.d_filtered = 0.0f;
+  pid->core.prev_d_in = 0.0f;
+  pid->core.d_primed = 0;
+
+  // 对称限幅，原有积分限幅方式，不限制变化率
+  pid->core.out_min = -limit;
+  pid->core.out_max = limit;
+  pid->core.slew_rate = 0.0f;
+  pid->core.prev_out = 0.0f;
+  pid->core.kb = 0.0f;
+  pid->core.aw_mode = PID_AW_Clamp;
+  pid->core.i_block = 0;
+  pid->out = 0.0f;
+}
+
+/**
+ * @brief 设置设定值权重(仅PIDUpdateSP使用)
+ * @param  pid pid环
+ * @param  beta 比例项权重，P = kp*(beta*sp - y)，减小可降低阶跃超调
+ * @param  gamma 微分项权重，D = kd*d(gamma*sp - y)/dt，0可消除微分冲击
+ */
+void PID_SetWeights(PIDControllerType *pid, float beta, float gamma) {
+  pid->core.beta = beta;
+  pid->core.gamma = gamma;
+}
+
+/**
+ * @brief 设置微分项一阶低通滤波(仅PIDUpdateSP使用)
+ * @param  pid pid环
+ * @param  cutoff 截止频率(Hz)，0为不滤波
+ */
+void PID_SetDerivativeFilter(PIDControllerType *pid, float cutoff) {
+  pid->core.d_cutoff = cutoff;
+}
+
+/**
+ * @brief 设置非对称输出限幅
+ * @param  pid pid环
+ * @param  min 输出下限
+ * @param  max 输出上限
+ * @note PID_AW_Clamp模式的积分限幅取两者绝对值的较大者
+ */
+void PID_SetOutputLimits(PIDControllerType *pid, float min, float max) {
+  pid->core.out_min = min;
+  pid->core.out_max = max;
+  pid->core.output_limit = (-min > max) ? -min : max;
+}
+
+/**
+ * @brief 设置输出变化率限制
+ * @param  pid pid环
+ * @param  rate 每秒最大变化量，0为不限制
+ */
+void PID_SetSlewRate(PIDControllerType *pid, float rate) {
+  pid->core.slew_rate = rate;
+}
+
+/**
+ * @brief 设置积分抗饱和方式
+ * @param  pid pid环
+ * @param  mode 抗饱和方式
+ * @param  kb 反算增益(1/s)，仅PID_AW_BackCalc使用
+ */
+void PID_SetAntiWindup(PIDControllerType *pid, PIDAntiWindupType mode,
+                       float kb) {
+  pid->core.aw_mode = mode;
+  pid->core.kb = kb;
+}
+
+/**
+ * @brief 按方向冻结积分，供串级等外部饱和信息使用
+ * @param  pid pid环
+ * @param  dir 1禁止误差为正时积分，-1禁止误差为负时积分，0解除
+ * @note 按ki不小于0判断方向，在任意抗饱和方式之前生效
+ */
+void PID_BlockIntegral(PIDControllerType *pid, int8_t dir) {
+  pid->core.i_block = dir;
 }
 
 /**
@@ -26,29 +114,275 @@ void PID_Init(PIDControllerType *pid, float kp, float ki, float kd,
  * @param  dt 时间间隔
  */
 void PIDUpdate(PIDControllerType *pid, float error, float dt) {
+  // 微分项
+  float derivative = (error - pid->core.prev_error) / dt;
+  pid->core.prev_error = error;
+
+  // 积分、PID输出与限幅
+  PIDOutput(pid, error, pid->core.kp * error + pid->core.kd * derivative, dt);
+}
+
+/**
+ * @brief PID计算，设定值与测量值分开输入
+ * @param  pid pid环
+ * @param  setpoint 设定值
+ * @param  measurement 测量值
+ * @param  dt 时间间隔
+ * @note 比例项与微分项按设定值权重计算，积分项使用完整误差；
+ *       微分项经一阶低通滤波，首次调用不产生微分输出
+ */
+void PIDUpdateSP(PIDControllerType *pid, float setpoint, float measurement,
+                 float dt) {
+  PIDControllerCore *core = &pid->core;
+  float error = setpoint - measurement;
+  float dIn = core->gamma * setpoint - measurement;
+  float derivative = 0.0f;
+
+  // 微分项(测量值微分+低通滤波)
+  if (core->d_primed) {
+    derivative = (dIn - core->prev_d_in) / dt;
+    if (core->d_cutoff > 0.0f) {
+      // alpha = dt / (tau + dt), tau = 1 / (2*pi*fc)
+      float alpha = dt / (1.0f / (6.2831853f * core->d_cutoff) + dt);
+      derivative =
+          core->d_filtered + alpha * (derivative - core->d_filtered);
+    }
+  }
+  core->d_filtered = derivative;
+  core->prev_d_in = dIn;
+  core->prev_error = error;
+  core->d_primed = 1;
+
+  // 积分、PID输出与限幅
+  PIDOutput(pid, error,
+            core->kp * (core->beta * setpoint - measurement) +
+                core->kd * derivative,
+            dt);
+}
+
+/**
+ * @brief 初始化定周期pid，按dt预先折算系数
+ * @param  pid 定周期pid环
+ * @param  kp 比例系数
+ * @param  ki 积分系数
+ * @param  kd 微分系数
+ * @param  limit 输出限幅(对称)，积分项同样限制在该范围内
+ * @param  dt 固定的控制周期(s)
+ */
+void PIDFixedRate_Init(PIDFixedRateType *pid, float kp, float ki, float kd,
+                       float limit, float dt) {
+  pid->kp = kp;
+  pid->ki_dt = ki * dt;
+  pid->kd_dt = kd / dt;
+  pid->i_term = 0.0f;
+  pid->prev_error = 0.0f;
+  pid->out_min = -limit;
+  pid->out_max = limit;
+  pid->out = 0.0f;
+}
+
+/**
+ * @brief 定周期PID计算，只有乘加与比较
+ * @param  pid 定周期pid环
+ * @param  error 误差输入
+ * @return float 限幅后的输出
+ * @note 积分项限制在输出范围内，与PIDUpdate的output_limit/ki限幅等价
+ */
+float PIDFixedRateUpdate(PIDFixedRateType *pid, float error) {
+  float out;
+
   // 积分项
-  pid->core.integral += error * dt;
+  pid->i_term += pid->ki_dt * error;
+  if (pid->i_term > pid->out_max)
+    pid->i_term = pid->out_max;
+  if (pid->i_term < pid->out_min)
+    pid->i_term = pid->out_min;
 
-  // 积分限幅
-  if (pid->core.ki > 0) {
-    float max_integral = pid->core.output_limit / pid->core.ki;
-    if (pid->core.integral > max_integral)
-      pid->core.integral = max_integral;
-    if (pid->core.integral < -max_integral)
-      pid->core.integral = -max_integral;
+  // PID输出
+  out = pid->kp * error + pid->i_term + pid->kd_dt * (error - pid->prev_error);
+  pid->prev_error = error;
+
+  // 限幅
+  if (out > pid->out_max)
+    out = pid->out_max;
+  if (out < pid->out_min)
+    out = pid->out_min;
+  pid->out = out;
+  return out;
+}
+
+/**
+ * @brief 初始化Q15定点pid，系数在此处一次性由浮点折算
+ * @param  pid Q15 pid环
+ * @param  kp 比例系数
+ * @param  ki 积分系数
+ * @param  kd 微分系数
+ * @param  limit 输出限幅(Q15，对称)，积分项同样限制在该范围内
+ * @param  dt 固定的控制周期(s)
+ * @param  shift 系数缩放位数，需满足kp、ki*dt、kd/dt均小于2^shift，超出则饱和
+ */
+void PIDQ15_Init(PIDQ15Type *pid, float kp, float ki, float kd, int16_t limit,
+                 float dt, uint8_t shift) {
+  if (shift > 15) {
+    shift = 15;
+  }
+  if (limit < 0) {
+    // -INT16_MIN超出int16范围，饱和为INT16_MAX
+    limit = (limit == INT16_MIN) ? INT16_MAX : (int16_t)-limit;
   }
 
-  // 微分项
-  float derivative = (error - pid->core.prev_error) / dt;
-  pid->core.prev_error = error;
+  pid->shift = shift;
+  pid->kp = PIDQ15Gain(kp, shift);
+  pid->ki_dt = PIDQ15Gain(ki * dt, shift);
+  pid->kd_dt = PIDQ15Gain(kd / dt, shift);
+  pid->i_acc = 0;
+  pid->prev_error = 0;
+  pid->out_min = (int16_t)-limit;
+  pid->out_max = limit;
+  pid->out = 0;
+}
+
+/**
+ * @brief Q15定点PID计算，只有整数乘加与移位
+ * @param  pid Q15 pid环
+ * @param  error 误差输入(Q15)
+ * @return int16_t 限幅后的输出(Q15)
+ * @note 三项乘积均在Q30域计算，积分累加值限制在输出范围内不会溢出；
+ *       shift为15时三项之和可达2^31，求和在64位中进行
+ */
+int16_t PIDQ15Update(PIDQ15Type *pid, int16_t error) {
+  uint8_t sh = (uint8_t)(15 - pid->shift);
+  int32_t iMax = (int32_t)pid->out_max * (1L << sh);
+  int32_t iMin = (int32_t)pid->out_min * (1L << sh);
+  int32_t de;
+  int64_t out;
+
+  // 积分项
+  pid->i_acc += (int32_t)pid->ki_dt * error;
+  if (pid->i_acc > iMax)
+    pid->i_acc = iMax;
+  if (pid->i_acc < iMin)
+    pid->i_acc = iMin;
+
+  // 误差差分饱和到16位，避免乘积溢出
+  de = (int32_t)error - pid->prev_error;
+  if (de > INT16_MAX)
+    de = INT16_MAX;
+  if (de < INT16_MIN)
+    de = INT16_MIN;
+  pid->prev_error = error;
 
   // PID输出
-  pid->out = pid->core.kp * error + pid->core.ki * pid->core.integral +
-             pid->core.kd * derivative;
+  out = (int64_t)(((int32_t)pid->kp * error) >> sh) + (pid->i_acc >> sh) +
+        (((int32_t)pid->kd_dt * de) >> sh);
 
   // 限幅
-  if (pid->out > pid->core.output_limit)
-    pid->out = pid->core.output_limit;
-  if (pid->out < -pid->core.output_limit)
-    pid->out = -pid->core.output_limit;
+  if (out > pid->out_max)
+    out = pid->out_max;
+  if (out < pid->out_min)
+    out = pid->out_min;
+  pid->out = (int16_t)out;
+  return pid->out;
+}
+
+/**
+ * @brief 积分并按抗饱和方式计算限幅后的输出
+ * @param  pid pid环
+ * @param  error 误差
+ * @param  pd 比例项与微分项之和
+ * @param  dt 时间间隔
+ */
+static void PIDOutput(PIDControllerType *pid, float error, float pd,
+                      float dt) {
+  PIDControllerCore *core = &pid->core;
+  float increment = error * dt;
+  float unsat, out, step;
+
+  // 外部冻结该方向的积分
+  if (((core->i_block > 0) && (error > 0.0f)) ||
+      ((core->i_block < 0) && (error < 0.0f))) {
+    increment = 0.0f;
+  }
+
+  // 积分项
+  if (core->aw_mode == PID_AW_Conditional) {
+    // 试算计入本次积分后的输出，未饱和或误差使输出退出饱和时才累加本次积分
+    unsat = pd + core->ki * (core->integral + increment);
+    out = PIDClampOutput(core, unsat);
+    if ((out == unsat) || ((unsat > out) == (error < 0.0f))) {
+      core->integral += increment;
+    }
+  } else {
+    core->integral += increment;
+    if (core->aw_mode == PID_AW_Clamp) {
+      // 积分限幅
+      PIDClampIntegral(core);
+    }
+  }
+
+  // PID输出与限幅
+  unsat = pd + core->ki * core->integral;
+  out = PIDClampOutput(core, unsat);
+
+  // 变化率限制
+  if (core->slew_rate > 0.0f) {
+    step = core->slew_rate * dt;
+    if (out > core->prev_out + step)
+      out = core->prev_out + step;
+    if (out < core->prev_out - step)
+      out = core->prev_out - step;
+  }
+
+  // 反算抗饱和: 实际输出与未限幅输出之差回馈到积分
+  if ((core->aw_mode == PID_AW_BackCalc) && (core->ki > 0)) {
+    core->integral += core->kb * (out - unsat) * dt / core->ki;
+  }
+
+  core->prev_out = out;
+  pid->out = out;
+}
+
+/**
+ * @brief 积分限幅，使积分项单独作用不超过输出限幅
+ * @param  core pid核心
+ */
+static void PIDClampIntegral(PIDControllerCore *core) {
+  if (core->ki > 0) {
+    float max_integral = core->output_limit / core->ki;
+    if (core->integral > max_integral)
+      core->integral = max_integral;
+    if (core->integral < -max_integral)
+      core->integral = -max_integral;
+  }
+}
+
+/**
+ * @brief 输出限幅
+ * @param  core pid核心
+ * @param  out 限幅前的输出
+ * @return float 限幅后的输出
+ */
+static float PIDClampOutput(PIDControllerCore *core, float out) {
+  if (out > core->out_max)
+    out = core->out_max;
+  if (out < core->out_min)
+    out = core->out_min;
+  return out;
+}
+
+/**
+ * @brief 浮点系数转Q15，按2^shift缩放并饱和
+ * @param  gain 浮点系数
+ * @param  shift 缩放位数
+ * @return int16_t Q15系数
+ */
+static int16_t PIDQ15Gain(float gain, uint8_t shift) {
+  float q = gain * 32768.0f / (float)(1L << shift);
+
+  q += (q >= 0.0f) ? 0.5f : -0.5f;
+  if (q > 32767.0f)
+    return INT16_MAX;
+  if (q < -32768.0f)
+    return INT16_MIN;
+  return (int16_t)q;
 }
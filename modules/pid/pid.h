@@ -3,6 +3,13 @@
 
 #include <stdint.h>
 
+/*积分抗饱和方式*/
+typedef enum {
+  PID_AW_Clamp,       // 积分限幅为output_limit/ki(原有方式)
+  PID_AW_Conditional, // 条件积分: 输出饱和且误差使其更饱和时停止积分
+  PID_AW_BackCalc,    // 反算: 按(实际输出-未限幅输出)*kb回退积分
+} PIDAntiWindupType;
+
 // pid控制器核心
 typedef struct {
   float kp;           // 比例系数
@@ -11,6 +18,21 @@ typedef struct {
   float integral;     // 积分累积值
   float prev_error;   // 上一次误差
   float output_limit; // PID输出限幅
+  /*设定值/测量值分离模式(PIDUpdateSP)*/
+  float beta;        // 比例项设定值权重，1为标准PID
+  float gamma;       // 微分项设定值权重，0为纯测量微分(无微分冲击)
+  float d_cutoff;    // 微分低通截止频率(Hz)，0为不滤波
+  float d_filtered;  // 滤波后的微分项
+  float prev_d_in;   // 上一次微分输入(gamma*设定值-测量值)
+  uint8_t d_primed;  // 微分输入已有历史值
+  /*输出与抗饱和*/
+  float out_min;             // 输出下限
+  float out_max;             // 输出上限
+  float slew_rate;           // 输出变化率上限(单位/s)，0为不限制
+  float prev_out;            // 上一次输出，用于变化率限制
+  float kb;                  // 反算抗饱和增益(1/s)，常取ki/kp附近
+  PIDAntiWindupType aw_mode; // 积分抗饱和方式
+  int8_t i_block;            // 积分方向冻结: 1禁止正向，-1禁止负向，0不限制
 } PIDControllerCore;
 
 /*mahony控制器数据类型*/
@@ -19,8 +41,49 @@ typedef struct {
   float out; // pid输出的控制量
 } PIDControllerType;
 
+/*定周期pid，系数在初始化时按dt预先折算，更新时无除法*/
+typedef struct {
+  float kp;         // 比例系数
+  float ki_dt;      // ki * dt
+  float kd_dt;      // kd / dt
+  float i_term;     // 积分项(已乘ki)
+  float prev_error; // 上一次误差
+  float out_min;    // 输出下限，同时限制积分项
+  float out_max;    // 输出上限，同时限制积分项
+  float out;        // pid输出的控制量
+} PIDFixedRateType;
+
+/*定周期Q15定点pid，误差与输出均为Q15，供无FPU的内核使用*/
+typedef struct {
+  int16_t kp;         // Q15比例系数，实际值为kp * 2^shift / 32768
+  int16_t ki_dt;      // Q15的ki * dt，缩放同上
+  int16_t kd_dt;      // Q15的kd / dt，缩放同上
+  uint8_t shift;      // 系数缩放位数(0~15)，允许的系数上限为2^shift
+  int32_t i_acc;      // 积分累加值，Q(30-shift)
+  int16_t prev_error; // 上一次误差
+  int16_t out_min;    // 输出下限(Q15)，同时限制积分项
+  int16_t out_max;    // 输出上限(Q15)，同时限制积分项
+  int16_t out;        // pid输出的控制量(Q15)
+} PIDQ15Type;
+
 void PID_Init(PIDControllerType *pid, float kp, float ki, float kd,
               float limit);
+void PID_SetWeights(PIDControllerType *pid, float beta, float gamma);
+void PID_SetDerivativeFilter(PIDControllerType *pid, float cutoff);
+void PID_SetOutputLimits(PIDControllerType *pid, float min, float max);
+void PID_SetSlewRate(PIDControllerType *pid, float rate);
+void PID_SetAntiWindup(PIDControllerType *pid, PIDAntiWindupType mode,
+                       float kb);
+void PID_BlockIntegral(PIDControllerType *pid, int8_t dir);
 void PIDUpdate(PIDControllerType *pid, float error, float dt);
+void PIDUpdateSP(PIDControllerType *pid, float setpoint, float measurement,
+                 float dt);
+
+void PIDFixedRate_Init(PIDFixedRateType *pid, float kp, float ki, float kd,
+                       float limit, float dt);
+float PIDFixedRateUpdate(PIDFixedRateType *pid, float error);
+void PIDQ15_Init(PIDQ15Type *pid, float kp, float ki, float kd, int16_t limit,
+                 float dt, uint8_t shift);
+int16_t PIDQ15Update(PIDQ15Type *pid, int16_t error);
 
 #endif // !PID_H
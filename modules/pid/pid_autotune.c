@@ -0,0 +1,191 @@
+#include "pid_autotune.h"
+#include <math.h>
+
+/**
+ * @brief 初始化继电反馈自整定
+ * @param  tune 自整定对象
+ * @param  setpoint 实验工作点，测量值围绕该点振荡
+ * @param  bias 继电输出中心值，使被控对象大致停在工作点附近的控制量
+ * @param  amplitude 继电输出幅值，输出在bias±amplitude之间切换
+ * @param  hysteresis 继电回差，应大于测量噪声峰峰值的一半
+ * @param  cycles 参与平均的振荡周期数，0按1处理；首个周期为过渡过程不计入
+ * @param  timeout 实验时间上限(s)，0为不限制
+ */
+void PIDAutoTune_Init(PIDAutoTuneType *tune, float setpoint, float bias,
+                      float amplitude, float hysteresis, uint8_t cycles,
+                      float timeout) {
+  tune->setpoint = setpoint;
+  tune->bias = bias;
+  tune->amplitude = fabsf(amplitude);
+  tune->hysteresis = fabsf(hysteresis);
+  tune->timeout = timeout;
+  tune->cycles = (cycles == 0) ? 1 : cycles;
+
+  tune->relay = 0;
+  tune->rises = 0;
+  tune->elapsed = 0.0f;
+  tune->timer = 0.0f;
+  tune->peak_max = -INFINITY;
+  tune->peak_min = INFINITY;
+  tune->sum_period = 0.0f;
+  tune->sum_amp = 0.0f;
+  tune->ku = 0.0f;
+  tune->tu = 0.0f;
+  tune->out = bias;
+  tune->state = PID_TUNE_Running;
+}
+
+/**
+ * @brief 自整定单步，在控制节拍中代替PIDUpdate调用，输出见tune->out
+ * @param  tune 自整定对象
+ * @param  measurement 测量值
+ * @param  dt 时间间隔
+ * @return PIDAutoTuneState 整定状态，非Running时输出回到bias
+ * @note 每次继电上升沿结束一个周期，记录周期与峰峰值；
+ *       Ku = 4d / (pi * sqrt(a^2 - h^2))，a为振幅，h为回差
+ */
+PIDAutoTuneState PIDAutoTuneUpdate(PIDAutoTuneType *tune, float measurement,
+                                   float dt) {
+  float error = tune->setpoint - measurement;
+  float a;
+
+  if (tune->state != PID_TUNE_Running) {
+    tune->out = tune->bias;
+    return tune->state;
+  }
+
+  tune->elapsed += dt;
+  tune->timer += dt;
+  if ((tune->timeout > 0.0f) && (tune->elapsed > tune->timeout)) {
+    tune->state = PID_TUNE_Failed;
+    tune->out = tune->bias;
+    return tune->state;
+  }
+
+  // 本周期峰值
+  if (measurement > tune->peak_max)
+    tune->peak_max = measurement;
+  if (measurement < tune->peak_min)
+    tune->peak_min = measurement;
+
+  // 首次调用按误差方向确定继电方向
+  if (tune->relay == 0) {
+    tune->relay = (error >= 0.0f) ? 1 : -1;
+  }
+
+  // 带回差的继电切换
+  if ((tune->relay > 0) && (error < -tune->hysteresis)) {
+    tune->relay = -1;
+  } else if ((tune->relay < 0) && (error > tune->hysteresis)) {
+    tune->relay = 1;
+
+    // 上升沿: 首个周期为过渡过程，之后每个周期计入平均
+    if (tune->rises > 0) {
+      tune->sum_period += tune->timer;
+      tune->sum_amp += 0.5f * (tune->peak_max - tune->peak_min);
+    }
+    tune->timer = 0.0f;
+    tune->peak_max = measurement;
+    tune->peak_min = measurement;
+
+    if (tune->rises++ >= tune->cycles) {
+      a = tune->sum_amp / (float)tune->cycles;
+      tune->tu = tune->sum_period / (float)tune->cycles;
+      if (a <= tune->hysteresis) {
+        // 振幅被回差淹没，无法辨识
+        tune->state = PID_TUNE_Failed;
+      } else {
+        tune->ku = 4.0f * tune->amplitude /
+                   (3.1415927f * sqrtf(a * a - tune->hysteresis *
+                                                   tune->hysteresis));
+        tune->state = PID_TUNE_Done;
+      }
+      tune->out = tune->bias;
+      return tune->state;
+    }
+  }
+
+  tune->out = tune->bias + (float)tune->relay * tune->amplitude;
+  return tune->state;
+}
+
+/**
+ * @brief 按整定规则计算并联形式的pid系数
+ * @param  tune 已完成的自整定对象
+ * @param  rule 整定规则
+ * @param  kp 比例系数输出
+ * @param  ki 积分系数输出，kp / Ti
+ * @param  kd 微分系数输出，kp * Td
+ * @note 整定未完成时三者均为0
+ */
+void PIDAutoTuneGains(const PIDAutoTuneType *tune, PIDTuneRuleType rule,
+                      float *kp, float *ki, float *kd) {
+  float ku = tune->ku, tu = tune->tu;
+  float p, ti, td;
+
+  if (tune->state != PID_TUNE_Done) {
+    *kp = 0.0f;
+    *ki = 0.0f;
+    *kd = 0.0f;
+    return;
+  }
+
+  switch (rule) {
+  case PID_TUNE_ZieglerNicholsPI:
+    p = 0.45f * ku;
+    ti = tu / 1.2f;
+    td = 0.0f;
+    break;
+  case PID_TUNE_TyreusLuyben:
+    p = ku / 2.2f;
+    ti = 2.2f * tu;
+    td = tu / 6.3f;
+    break;
+  case PID_TUNE_PessenIntegral:
+    p = 0.7f * ku;
+    ti = 0.4f * tu;
+    td = 0.15f * tu;
+    break;
+  case PID_TUNE_NoOvershoot:
+    p = 0.2f * ku;
+    ti = 0.5f * tu;
+    td = tu / 3.0f;
+    break;
+  case PID_TUNE_ZieglerNichols:
+  default:
+    p = 0.6f * ku;
+    ti = 0.5f * tu;
+    td = 0.125f * tu;
+    break;
+  }
+
+  *kp = p;
+  *ki = p / ti;
+  *kd = p * td;
+}
+
+/**
+ * @brief 将整定结果写入pid环，保留限幅等其余设置并清零积分、微分与输出历史
+ * @param  tune 自整定对象
+ * @param  rule 整定规则
+ * @param  pid pid环
+ * @return PIDAutoTuneState 自整定状态，不为PID_TUNE_Done时不修改pid环
+ * @note 写入后输出从0开始，设有变化率限制时按slew_rate爬升
+ */
+PIDAutoTuneState PIDAutoTune_Apply(const PIDAutoTuneType *tune,
+                                   PIDTuneRuleType rule,
+                                   PIDControllerType *pid) {
+  if (tune->state != PID_TUNE_Done) {
+    return tune->state;
+  }
+
+  PIDAutoTuneGains(tune, rule, &pid->core.kp, &pid->core.ki, &pid->core.kd);
+  pid->core.integral = 0.0f;
+  pid->core.prev_error = 0.0f;
+  pid->core.d_filtered = 0.0f;
+  pid->core.prev_d_in = 0.0f;
+  pid->core.d_primed = 0;
+  pid->core.prev_out = 0.0f;
+  pid->out = 0.0f;
+  return tune->state;
+}
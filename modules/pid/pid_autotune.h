@@ -0,0 +1,57 @@
+#ifndef PID_AUTOTUNE_H
+#define PID_AUTOTUNE_H
+
+#include "pid.h"
+#include <stdint.h>
+
+/*整定状态*/
+typedef enum {
+  PID_TUNE_Running, // 继电实验进行中
+  PID_TUNE_Done,    // 已得到临界增益与周期
+  PID_TUNE_Failed,  // 超时或振幅不足
+} PIDAutoTuneState;
+
+/*整定规则，均由临界增益Ku与临界周期Tu计算*/
+typedef enum {
+  PID_TUNE_ZieglerNichols, // 经典Z-N: 0.6Ku, Tu/2, Tu/8
+  PID_TUNE_ZieglerNicholsPI, // Z-N PI: 0.45Ku, Tu/1.2
+  PID_TUNE_TyreusLuyben,   // T-L: Ku/2.2, 2.2Tu, Tu/6.3，超调小、鲁棒
+  PID_TUNE_PessenIntegral, // Pessen: 0.7Ku, 0.4Tu, 0.15Tu，响应快
+  PID_TUNE_NoOvershoot,    // 无超调: 0.2Ku, Tu/2, Tu/3
+} PIDTuneRuleType;
+
+/*继电反馈自整定，在控制节拍中增量运行，占用固定内存*/
+typedef struct {
+  float setpoint;   // 实验工作点
+  float bias;       // 继电输出中心值
+  float amplitude;  // 继电输出幅值d
+  float hysteresis; // 继电回差，应大于测量噪声
+  float timeout;    // 实验时间上限(s)，0为不限制
+  uint8_t cycles;   // 需要测量的振荡周期数
+  /*实验状态*/
+  int8_t relay;       // 继电方向，1为bias+d，-1为bias-d
+  uint8_t rises;      // 已出现的继电上升沿次数
+  float elapsed;      // 实验已运行时间
+  float timer;        // 本周期已运行时间
+  float peak_max;     // 本周期测量最大值
+  float peak_min;     // 本周期测量最小值
+  float sum_period;   // 已测周期之和
+  float sum_amp;      // 已测振幅之和
+  float ku;           // 临界增益
+  float tu;           // 临界周期(s)
+  float out;          // 继电输出的控制量
+  PIDAutoTuneState state;
+} PIDAutoTuneType;
+
+void PIDAutoTune_Init(PIDAutoTuneType *tune, float setpoint, float bias,
+                      float amplitude, float hysteresis, uint8_t cycles,
+                      float timeout);
+PIDAutoTuneState PIDAutoTuneUpdate(PIDAutoTuneType *tune, float measurement,
+                                   float dt);
+void PIDAutoTuneGains(const PIDAutoTuneType *tune, PIDTuneRuleType rule,
+                      float *kp, float *ki, float *kd);
+PIDAutoTuneState PIDAutoTune_Apply(const PIDAutoTuneType *tune,
+                                   PIDTuneRuleType rule,
+                                   PIDControllerType *pid);
+
+#endif // !PID_AUTOTUNE_H
@@ -0,0 +1,125 @@
+#include "pid_bank.h"
+#include <float.h>
+#include <string.h>
+
+static inline float PIDBankSelect(uint32_t mask, float a,
+                                  float b); // 按位掩码选择
+
+/**
+ * @brief 初始化pid组，所有通道增益为0且使能
+ * @param  bank pid组
+ * @param  count 通道数量，超出PID_BANK_MAX时截断
+ */
+void PIDBank_Init(PIDBankType *bank, uint8_t count) {
+  uint8_t ch;
+
+  if (count > PID_BANK_MAX) {
+    count = PID_BANK_MAX;
+  }
+  bank->count = count;
+
+  for (ch = 0; ch < PID_BANK_MAX; ch++) {
+    PIDBank_SetGains(bank, ch, 0.0f, 0.0f, 0.0f, 0.0f);
+    bank->integral[ch] = 0.0f;
+    bank->prev_error[ch] = 0.0f;
+    bank->out[ch] = 0.0f;
+    bank->enable[ch] = PID_BANK_ENABLED;
+  }
+}
+
+/**
+ * @brief 设置单个通道的参数
+ * @param  bank pid组
+ * @param  ch 通道号
+ * @param  kp 比例系数
+ * @param  ki 积分系数
+ * @param  kd 微分系数
+ * @param  limit 输出限幅
+ */
+void PIDBank_SetGains(PIDBankType *bank, uint8_t ch, float kp, float ki,
+                      float kd, float limit) {
+  bank->kp[ch] = kp;
+  bank->ki[ch] = ki;
+  bank->kd[ch] = kd;
+  bank->limit[ch] = limit;
+  // ki不大于0时不限制积分，与PIDUpdate一致
+  bank->i_max[ch] = (ki > 0.0f) ? (limit / ki) : FLT_MAX;
+}
+
+/**
+ * @brief 按位设置通道使能，bit n对应通道n
+ * @param  bank pid组
+ * @param  mask 使能掩码，被清零的通道保持状态与输出不变
+ */
+void PIDBank_SetEnableMask(PIDBankType *bank, uint32_t mask) {
+  uint8_t ch;
+
+  for (ch = 0; ch < PID_BANK_MAX; ch++) {
+    bank->enable[ch] = ((mask >> ch) & 1u) ? PID_BANK_ENABLED : 0u;
+  }
+}
+
+/**
+ * @brief 一次更新所有通道
+ * @param  bank pid组
+ * @param  error 各通道误差，长度不小于count
+ * @param  dt 时间间隔
+ * @note 循环体无分支，限幅为选择运算、使能为按位选择，便于编译器向量化；
+ *       未使能通道的误差即使为NaN/Inf也不会写入其状态；
+ *       每次调用只做一次除法(1/dt)
+ */
+void PIDBankUpdate(PIDBankType *bank, const float *restrict error,
+                   float dt) {
+  float *restrict integral = bank->integral;
+  float *restrict prevError = bank->prev_error;
+  float *restrict out = bank->out;
+  const float *restrict kp = bank->kp, *restrict ki = bank->ki;
+  const float *restrict kd = bank->kd, *restrict limit = bank->limit;
+  const float *restrict iMax = bank->i_max;
+  const uint32_t *restrict enable = bank->enable;
+  float invDt = 1.0f / dt;
+  uint8_t ch, n = bank->count;
+
+  for (ch = 0; ch < n; ch++) {
+    float e = error[ch];
+    uint32_t en = enable[ch];
+    float iOld = integral[ch], pOld = prevError[ch];
+
+    // 积分项与积分限幅
+    float i = iOld + e * dt;
+    i = (i > iMax[ch]) ? iMax[ch] : i;
+    i = (i < -iMax[ch]) ? -iMax[ch] : i;
+
+    // 微分项
+    float d = (e - pOld) * invDt;
+
+    // PID输出与限幅
+    float u = kp[ch] * e + ki[ch] * i + kd[ch] * d;
+    u = (u > limit[ch]) ? limit[ch] : u;
+    u = (u < -limit[ch]) ? -limit[ch] : u;
+
+    // 未使能的通道保持原值，按位选择而非乘法混合，避免0 * NaN污染状态
+    integral[ch] = PIDBankSelect(en, i, iOld);
+    prevError[ch] = PIDBankSelect(en, e, pOld);
+    out[ch] = PIDBankSelect(en, u, out[ch]);
+  }
+}
+
+/**
+ * @brief 按位掩码在两个浮点数间选择，编译为与/或运算而非分支
+ * @param  mask 全1选a，全0选b
+ * @param  a 候选值
+ * @param  b 候选值
+ * @return float 选择结果
+ * @note 条件表达式中的浮点运算可能触发异常，编译器不会将其转为无分支选择，
+ *       故按位操作
+ */
+static inline float PIDBankSelect(uint32_t mask, float a, float b) {
+  uint32_t ua, ub;
+
+  memcpy(&ua, &a, sizeof(ua));
+  memcpy(&ub, &b, sizeof(ub));
+  ua = (ua & mask) | (ub & ~mask);
+  memcpy(&a, &ua, sizeof(a));
+  return a;
+}
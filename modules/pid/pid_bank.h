@@ -0,0 +1,35 @@
+#ifndef PID_BANK_H
+#define PID_BANK_H
+
+#include <stdint.h>
+
+/*同一节拍更新的pid通道数量上限，不超过32(使能掩码为32位)*/
+#ifndef PID_BANK_MAX
+#define PID_BANK_MAX 32
+#endif
+
+// 通道使能掩码值，未使能为0
+#define PID_BANK_ENABLED 0xFFFFFFFFu
+
+/*多通道pid组，结构体数组(SoA)布局，算法与PIDUpdate相同；
+  1/dt预先求倒数且求和顺序不同，结果与PIDUpdate有舍入级差异*/
+typedef struct {
+  float kp[PID_BANK_MAX];         // 比例系数
+  float ki[PID_BANK_MAX];         // 积分系数
+  float kd[PID_BANK_MAX];         // 微分系数
+  float limit[PID_BANK_MAX];      // 输出限幅
+  float i_max[PID_BANK_MAX];      // 积分限幅limit/ki，设置增益时预先计算
+  float integral[PID_BANK_MAX];   // 积分累积值
+  float prev_error[PID_BANK_MAX]; // 上一次误差
+  float out[PID_BANK_MAX];        // pid输出的控制量
+  uint32_t enable[PID_BANK_MAX];  // 使能(PID_BANK_ENABLED)或冻结(0)
+  uint8_t count;                  // 实际使用的通道数量
+} PIDBankType;
+
+void PIDBank_Init(PIDBankType *bank, uint8_t count);
+void PIDBank_SetGains(PIDBankType *bank, uint8_t ch, float kp, float ki,
+                      float kd, float limit);
+void PIDBank_SetEnableMask(PIDBankType *bank, uint32_t mask);
+void PIDBankUpdate(PIDBankType *bank, const float *error, float dt);
+
+#endif // !PID_BANK_H
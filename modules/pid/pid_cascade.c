@@ -0,0 +1,87 @@
+#include "pid_cascade.h"
+
+/**
+ * @brief 初始化串级pid，所有级增益为0，分频为1
+ * @param  cascade 串级pid
+ * @param  count 级数，超出PID_CASCADE_MAX时截断
+ */
+void PIDCascade_Init(PIDCascadeType *cascade, uint8_t count) {
+  uint8_t i;
+
+  if (count > PID_CASCADE_MAX) {
+    count = PID_CASCADE_MAX;
+  }
+  cascade->count = count;
+  cascade->out = 0.0f;
+
+  for (i = 0; i < PID_CASCADE_MAX; i++) {
+    PIDCascade_SetStage(cascade, i, 0.0f, 0.0f, 0.0f, 0.0f, 1);
+  }
+}
+
+/**
+ * @brief 设置某一级的参数并清零其状态
+ * @param  cascade 串级pid
+ * @param  index 级号，0为最外环
+ * @param  kp 比例系数
+ * @param  ki 积分系数
+ * @param  kd 微分系数
+ * @param  limit 输出限幅，外环的限幅即内环设定值的范围
+ * @param  divider 分频系数，0按1处理；本级的dt为节拍dt * divider
+ */
+void PIDCascade_SetStage(PIDCascadeType *cascade, uint8_t index, float kp,
+                         float ki, float kd, float limit, uint16_t divider) {
+  PIDCascadeStage *stage = &cascade->stage[index];
+
+  PID_Init(&stage->pid, kp, ki, kd, limit);
+  stage->divider = (divider == 0) ? 1 : divider;
+  stage->counter = 0;
+  stage->saturated = 0;
+}
+
+/**
+ * @brief 串级PID计算，每个控制节拍调用一次
+ * @param  cascade 串级pid
+ * @param  setpoint 最外环设定值
+ * @param  measurement 各级测量值，measurement[i]对应stage[i]，长度不小于count
+ * @param  dt 节拍时间间隔
+ * @return float 最内环输出
+ * @note 各级由外向内依次判断分频，未到更新节拍的级保持上一次输出；
+ *       内环输出饱和时冻结外环在同一方向的积分，避免外环积分饱和
+ */
+float PIDCascadeUpdate(PIDCascadeType *cascade, float setpoint,
+                       const float *measurement, float dt) {
+  float sp = setpoint;
+  uint8_t i;
+
+  for (i = 0; i < cascade->count; i++) {
+    PIDCascadeStage *stage = &cascade->stage[i];
+    PIDControllerCore *core = &stage->pid.core;
+
+    if (stage->counter == 0) {
+      // 内环饱和方向即外环输出无法继续生效的方向
+      if (i + 1 < cascade->count) {
+        PID_BlockIntegral(&stage->pid, cascade->stage[i + 1].saturated);
+      }
+
+      PIDUpdateSP(&stage->pid, sp, measurement[i],
+                  dt * (float)stage->divider);
+
+      if (stage->pid.out >= core->out_max) {
+        stage->saturated = 1;
+      } else if (stage->pid.out <= core->out_min) {
+        stage->saturated = -1;
+      } else {
+        stage->saturated = 0;
+      }
+    }
+
+    if (++stage->counter >= stage->divider) {
+      stage->counter = 0;
+    }
+    sp = stage->pid.out;
+  }
+
+  cascade->out = sp;
+  return sp;
+}
@@ -0,0 +1,44 @@
+#ifndef PID_CASCADE_H
+#define PID_CASCADE_H
+
+#include "pid.h"
+#include <stdint.h>
+
+/*串级级数上限*/
+#ifndef PID_CASCADE_MAX
+#define PID_CASCADE_MAX 4
+#endif
+
+/*串级中的一级*/
+typedef struct {
+  PIDControllerType pid; // 本级pid，可直接用PID_Set*系列接口调整
+  uint16_t divider;      // 分频系数，每divider个节拍更新一次
+  uint16_t counter;      // 节拍计数
+  int8_t saturated;      // 最近一次输出饱和方向: 1上限，-1下限，0未饱和
+} PIDCascadeStage;
+
+/*串级pid，stage[0]为最外环，外环输出作为相邻内环的设定值*/
+typedef struct {
+  PIDCascadeStage stage[PID_CASCADE_MAX];
+  uint8_t count; // 实际级数
+  float out;     // 最内环输出的控制量
+} PIDCascadeType;
+
+void PIDCascade_Init(PIDCascadeType *cascade, uint8_t count);
+void PIDCascade_SetStage(PIDCascadeType *cascade, uint8_t index, float kp,
+                         float ki, float kd, float limit, uint16_t divider);
+float PIDCascadeUpdate(PIDCascadeType *cascade, float setpoint,
+                       const float *measurement, float dt);
+
+/**
+ * @brief 获取某一级的pid环，用于设置限幅、滤波等参数
+ * @param  cascade 串级pid
+ * @param  index 级号，0为最外环
+ * @return PIDControllerType* 该级pid环
+ */
+static inline PIDControllerType *PIDCascadeStagePID(PIDCascadeType *cascade,
+                                                    uint8_t index) {
+  return &cascade->stage[index].pid;
+}
+
+#endif // !PID_CASCADE_H
@@ -0,0 +1,142 @@
+#include "ringbuf.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief 初始化环形缓冲区
+ * @param  rb 环形缓冲区
+ * @param  storage 存储区，由调用者提供并在使用期间有效
+ * @param  size 存储区字节数，必须为2的幂
+ * @return RingBufErrorType
+ * @note 初始化期间生产者与消费者均不得访问
+ */
+RingBufErrorType RingBuf_Init(RingBufType *rb, uint8_t *storage,
+                              uint32_t size) {
+  if (storage == NULL || size == 0 || (size & (size - 1)) != 0) {
+    return RingBuf_InitError;
+  }
+
+  rb->buf = storage;
+  rb->mask = size - 1;
+  atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+  atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+
+  return RingBuf_Ok;
+}
+
+/**
+ * @brief 写入数据，仅生产者调用
+ * @param  rb 环形缓冲区
+ * @param  data 数据
+ * @param  len 字节数
+ * @return uint32_t 实际写入的字节数，空间不足时只写入能容纳的部分
+ * @note 跨越存储区末尾时分两段拷贝
+ */
+uint32_t RingBufPush(RingBufType *rb, const uint8_t *data, uint32_t len) {
+  uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+  uint32_t space = rb->mask + 1 - (head - tail);
+  uint32_t offset = head & rb->mask;
+  uint32_t first;
+
+  if (len > space) {
+    len = space;
+  }
+  first = rb->mask + 1 - offset;
+  if (first > len) {
+    first = len;
+  }
+
+  memcpy(&rb->buf[offset], data, first);
+  memcpy(rb->buf, data + first, len - first);
+
+  // 数据写完后再发布新的写索引
+  atomic_store_explicit(&rb->head, head + len, memory_order_release);
+  return len;
+}
+
+/**
+ * @brief 读出数据，仅消费者调用
+ * @param  rb 环形缓冲区
+ * @param  data 数据输出
+ * @param  len 最多读出的字节数
+ * @return uint32_t 实际读出的字节数
+ */
+uint32_t RingBufPop(RingBufType *rb, uint8_t *data, uint32_t len) {
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+  uint32_t used = head - tail;
+  uint32_t offset = tail & rb->mask;
+  uint32_t first;
+
+  if (len > used) {
+    len = used;
+  }
+  first = rb->mask + 1 - offset;
+  if (first > len) {
+    first = len;
+  }
+
+  memcpy(data, &rb->buf[offset], first);
+  memcpy(data + first, rb->buf, len - first);
+
+  // 数据读完后再释放空间
+  atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+  return len;
+}
+
+/**
+ * @brief 获取连续可写区域，供DMA接收直接写入，仅生产者调用
+ * @param  rb 环形缓冲区
+ * @param  span 连续可写区域首地址输出
+ * @return uint32_t 连续可写字节数，到存储区末尾为止
+ * @note 写入后调用RingBufCommitWrite发布
+ */
+uint32_t RingBufWriteSpan(RingBufType *rb, uint8_t **span) {
+  uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+  uint32_t space = rb->mask + 1 - (head - tail);
+  uint32_t offset = head & rb->mask;
+  uint32_t contiguous = rb->mask + 1 - offset;
+
+  *span = &rb->buf[offset];
+  return (space < contiguous) ? space : contiguous;
+}
+
+/**
+ * @brief 发布已写入连续区域的字节，仅生产者调用
+ * @param  rb 环形缓冲区
+ * @param  len 字节数，不超过RingBufWriteSpan的返回值
+ */
+void RingBufCommitWrite(RingBufType *rb, uint32_t len) {
+  uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+  atomic_store_explicit(&rb->head, head + len, memory_order_release);
+}
+
+/**
+ * @brief 获取连续可读区域，供DMA发送直接读取，仅消费者调用
+ * @param  rb 环形缓冲区
+ * @param  span 连续可读区域首地址输出
+ * @return uint32_t 连续可读字节数，到存储区末尾为止
+ * @note DMA发送完成后再调用RingBufCommitRead释放
+ */
+uint32_t RingBufReadSpan(RingBufType *rb, uint8_t **span) {
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+  uint32_t used = head - tail;
+  uint32_t offset = tail & rb->mask;
+  uint32_t contiguous = rb->mask + 1 - offset;
+
+  *span = &rb->buf[offset];
+  return (used < contiguous) ? used : contiguous;
+}
+
+/**
+ * @brief 释放已读取连续区域的字节，仅消费者调用
+ * @param  rb 环形缓冲区
+ * @param  len 字节数，不超过RingBufReadSpan的返回值
+ */
+void RingBufCommitRead(RingBufType *rb, uint32_t len) {
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+  atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+}
@@ -0,0 +1,55 @@
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*读写索引分别独占的对齐字节数，避免生产者与消费者互相使缓存行失效*/
+#ifndef RINGBUF_CACHE_LINE
+#define RINGBUF_CACHE_LINE 32
+#endif
+
+/*环形缓冲区错误类型*/
+typedef enum {
+  RingBuf_Ok,
+  RingBuf_InitError, // 存储为空或容量不是2的幂
+} RingBufErrorType;
+
+/*单生产者单消费者(SPSC)无锁环形缓冲区，索引自由递增，按mask取模，容量为2的幂*/
+typedef struct RingBuf {
+  _Alignas(RINGBUF_CACHE_LINE) _Atomic uint32_t head; // 写索引，仅生产者修改
+  _Alignas(RINGBUF_CACHE_LINE) _Atomic uint32_t tail; // 读索引，仅消费者修改
+  _Alignas(RINGBUF_CACHE_LINE) uint8_t *buf;          // 存储区
+  uint32_t mask;                                      // 容量 - 1
+} RingBufType;
+
+RingBufErrorType RingBuf_Init(RingBufType *rb, uint8_t *storage,
+                              uint32_t size);
+uint32_t RingBufPush(RingBufType *rb, const uint8_t *data, uint32_t len);
+uint32_t RingBufPop(RingBufType *rb, uint8_t *data, uint32_t len);
+uint32_t RingBufWriteSpan(RingBufType *rb, uint8_t **span);
+void RingBufCommitWrite(RingBufType *rb, uint32_t len);
+uint32_t RingBufReadSpan(RingBufType *rb, uint8_t **span);
+void RingBufCommitRead(RingBufType *rb, uint32_t len);
+
+/**
+ * @brief 已写入未读出的字节数，生产者与消费者均可调用
+ * @param  rb 环形缓冲区
+ * @return uint32_t 字节数
+ */
+static inline uint32_t RingBufUsed(RingBufType *rb) {
+  // 先读tail再读head，保证head不落后于tail
+  uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+  return atomic_load_explicit(&rb->head, memory_order_acquire) - tail;
+}
+
+/**
+ * @brief 剩余可写入的字节数，生产者与消费者均可调用
+ * @param  rb 环形缓冲区
+ * @return uint32_t 字节数
+ */
+static inline uint32_t RingBufFree(RingBufType *rb) {
+  return rb->mask + 1 - RingBufUsed(rb);
+}
+
+#endif // !RINGBUF_H
@@ -1,15 +1,20 @@
 #include "vofa.h"
+#include "ringbuf.h"
 #include <stdint.h>
 #include <string.h>
 
-// 配置表,根据实际使用更改
-// |数据就绪状态|数据对应的标识ID|数据|
-static VOFARxTable rxTable[] = {
-    {default_init, 00, 00},
-};
+// vofa使用justfloat协议通信时的帧尾
+const uint8_t VOFAJustFloatTail[4] = {0x00, 0x00, 0x80, 0x7f};
 
 static uint8_t Frame_float2uint8(float *pSrc, uint8_t *pDst,
                                  uint8_t len); // float数据转uint8数据
+static uint8_t VOFATxSwapAndSend(VOFAContronllerType *vofa); // 交换缓冲并发送
+static uint8_t VOFATxFireWater(VOFAContronllerType *vofa); // FireWater协议发送
+static float VOFAChannelValue(const VOFAChannelType *ch); // 读取通道值
+static uint8_t VOFAUintToStr(uint32_t value, uint8_t minDigits,
+                             char *pDst); // 无符号整数转十进制字符串
+static VOFARxState VOFARxAccept(VOFAContronllerType *vofa,
+                                const uint8_t *frame); // 校验一帧并存入缓冲表
 
 /**
  * @brief vofa控制器的初始化，同时初始化自动管理的收发帧
@@ -17,18 +22,31 @@ static uint8_t Frame_float2uint8(float *pSrc, uint8_t *pDst,
  * @param vofa VOFAContronllerType类型地址
  * @param tx 串口发送的函数指针
  * @param rx 串口接收的函数指针
- * @param irq 中断获取函数指针
+ * @param table 接收缓冲表，由调用者定义并在整个使用期间有效，不接收时可为NULL
+ * @param tableLen 表项数量
  * @return VOFAErrorType
- * @note 解析配置表需要手动修改(vofa.c)
+ * @note 接收缓冲表示例，|数据就绪状态|数据对应的标识ID|数据|绑定变量(可省略)|:
+ *       static VOFARxTable table[] = {{VOFA_RX_DEFAULT_INIT, 0x01, 0, &pid.core.kp}};
+ *       ID重复时以靠前的表项为准
  */
 VOFAErrorType VOFAContronllerInit(VOFAContronllerType *vofa, VofaUartTx tx,
-                                  VofaUartRx rx) {
+                                  VofaUartRx rx, VOFARxTable *table,
+                                  uint8_t tableLen) {
+  uint8_t cnt;
 
   /*检查注入函数是否空缺*/
-  if (tx == NULL || rx == NULL) {
+  if (tx == NULL || rx == NULL || (table == NULL && tableLen != 0)) {
     return vofa_Absent;
   }
 
+  /*建立ID到表项的映射*/
+  vofa->rxTable = table;
+  vofa->rxTableLen = tableLen;
+  memset(vofa->rxIndex, VOFA_RX_ID_NONE, sizeof(vofa->rxIndex));
+  for (cnt = tableLen; cnt > 0; cnt--) {
+    vofa->rxIndex[table[cnt - 1].fID] = cnt - 1;
+  }
+
   /*帧内容初始化*/
   vofa->rxFrame = (VOFARxFrameType){
       .fHead = 0xFF,
@@ -38,44 +56,292 @@ VOFAErrorType VOFAContronllerInit(VOFAContronllerType *vofa, VofaUartTx tx,
   vofa->txFrame = (VOFATxFrameType){
       .fLen = 0x00,
       .fData = NULL,
+      .tailReserved = 0,
   };
 
+  /*默认justfloat协议*/
+  vofa->protocol = VOFA_JustFloat;
+  vofa->precision = 4;
+
   /*注入函数*/
   vofa->TxMessage = tx;
   vofa->RxMessage = rx;
 
+  /*异步发送默认不启用*/
+  vofa->TxMessageAsync = NULL;
+  vofa->txBuf[0] = NULL;
+  vofa->txBuf[1] = NULL;
+  vofa->txLen = 0;
+  vofa->txBack = 0;
+  vofa->txBusy = 0;
+  vofa->txPending = 0;
+  vofa->txDropped = 0;
+
+  /*默认不使用缓冲*/
+  vofa->txRing = NULL;
+  vofa->rxRing = NULL;
+
+  /*通道注册表默认为空*/
+  vofa->channels = NULL;
+  vofa->channelMax = 0;
+  vofa->channelCount = 0;
+
+  /*流式接收状态*/
+  vofa->rxCount = 0;
+  vofa->rxErrors = 0;
+
+  return vofa_Ok;
+}
+
+/**
+ * @brief 设置缓冲模式
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param txRing 发送缓冲，NULL为直接发送；非NULL时各发送函数只写入缓冲，由VOFATxPump发出
+ * @param rxRing 接收缓冲，NULL为不使用；非NULL时中断调用VOFA_RxPush，主循环调用VOFA_RxPoll解析
+ * @note 缓冲区需已由RingBuf_Init初始化
+ */
+void VOFA_SetBuffers(VOFAContronllerType *vofa, struct RingBuf *txRing,
+                     struct RingBuf *rxRing) {
+  vofa->txRing = txRing;
+  vofa->rxRing = rxRing;
+}
+
+/**
+ * @brief 发送一段数据，所有发送函数经由此处
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param pBuff 数据
+ * @param len 字节数
+ * @return uint8_t 0为成功
+ * @note 缓冲模式下整段写入发送缓冲，空间不足时整段丢弃、计入txDropped并返回1
+ */
+uint8_t VOFATxWrite(VOFAContronllerType *vofa, uint8_t *pBuff, uint8_t len) {
+  if (vofa->txRing == NULL) {
+    return vofa->TxMessage(pBuff, len);
+  }
+
+  if (RingBufFree(vofa->txRing) < len) {
+    vofa->txDropped++;
+    return 1;
+  }
+  RingBufPush(vofa->txRing, pBuff, len);
+  return 0;
+}
+
+/**
+ * @brief 将发送缓冲中的数据按连续段交给TxMessage，在主循环中调用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return VOFAErrorType
+ * @note 每段发送返回后才释放缓冲；使用DMA时应直接用RingBufReadSpan/RingBufCommitRead，
+ *       在发送完成中断中释放
+ */
+VOFAErrorType VOFATxPump(VOFAContronllerType *vofa) {
+  uint8_t status = 0;
+  uint8_t *span;
+  uint32_t len;
+
+  if (vofa->txRing == NULL) {
+    return vofa_Absent;
+  }
+
+  while ((len = RingBufReadSpan(vofa->txRing, &span)) != 0) {
+    if (len > 255) {
+      len = 255;
+    }
+    status += vofa->TxMessage(span, (uint8_t)len);
+    RingBufCommitRead(vofa->txRing, len);
+  }
+  return (status != 0) ? vofa_Error : vofa_Ok;
+}
+
+/**
+ * @brief 将串口收到的字节写入接收缓冲，在串口接收/IDLE中断中调用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param bytes 收到的字节
+ * @param len 字节数
+ * @return uint16_t 实际写入的字节数，缓冲已满时多余字节丢弃
+ */
+uint16_t VOFA_RxPush(VOFAContronllerType *vofa, const uint8_t *bytes,
+                     uint16_t len) {
+  if (vofa->rxRing == NULL) {
+    return 0;
+  }
+  return (uint16_t)RingBufPush(vofa->rxRing, bytes, len);
+}
+
+/**
+ * @brief 解析接收缓冲中的全部字节，在主循环中调用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return uint8_t 本次成功存入缓冲表的帧数
+ * @note 直接在缓冲区上解析，不拷贝
+ */
+uint8_t VOFA_RxPoll(VOFAContronllerType *vofa) {
+  uint8_t accepted = 0;
+  uint8_t *span;
+  uint32_t len;
+
+  if (vofa->rxRing == NULL) {
+    return 0;
+  }
+
+  while ((len = RingBufReadSpan(vofa->rxRing, &span)) != 0) {
+    if (len > 0xFFFF) {
+      len = 0xFFFF;
+    }
+    accepted += VOFA_RxFeed(vofa, span, (uint16_t)len);
+    RingBufCommitRead(vofa->rxRing, len);
+  }
+  return accepted;
+}
+
+/**
+ * @brief 启用异步双缓冲发送，并在两个缓冲区末尾预先写好帧尾
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param txAsync 启动异步发送的函数指针，返回0表示已启动，发送期间缓冲区不可改动
+ * @param bufA 缓冲区A，至少VOFA_TX_FRAME_FLOATS(len)个float
+ * @param bufB 缓冲区B，大小同上
+ * @param len 每帧的通道数，不超过VOFA_TX_MAX_CHANNELS
+ * @return VOFAErrorType
+ * @note 发送完成中断中需调用VOFATxCpltCallback
+ */
+VOFAErrorType VOFA_AsyncInit(VOFAContronllerType *vofa, VofaUartTxAsync txAsync,
+                             float *bufA, float *bufB, uint8_t len) {
+  if (txAsync == NULL || bufA == NULL || bufB == NULL) {
+    return vofa_Absent;
+  }
+  if (len == 0 || len > VOFA_TX_MAX_CHANNELS) {
+    return vofa_DataError;
+  }
+
+  vofa->TxMessageAsync = txAsync;
+  vofa->txBuf[0] = bufA;
+  vofa->txBuf[1] = bufB;
+  vofa->txLen = len;
+  vofa->txBack = 0;
+  vofa->txBusy = 0;
+  vofa->txPending = 0;
+  vofa->txDropped = 0;
+
+  /*帧尾固定，只写一次*/
+  memcpy(&bufA[len], VOFAJustFloatTail, 4);
+  memcpy(&bufB[len], VOFAJustFloatTail, 4);
+
+  return vofa_Ok;
+}
+
+/**
+ * @brief 将各通道当前值拷贝到后台缓冲区，链路空闲时立即开始发送
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param data 通道数据，txLen个float，返回后即可修改
+ * @return VOFAErrorType vofa_Error为启动发送失败
+ * @note 不阻塞，开销为拷贝txLen个float；上一帧未发出时被新帧覆盖并计入txDropped。
+ *       与VOFATxCpltCallback所在中断不应互相抢占(同优先级或关中断调用)
+ */
+VOFAErrorType VOFATxSnapshot(VOFAContronllerType *vofa, const float *data) {
+  if (vofa->TxMessageAsync == NULL) {
+    return vofa_Absent;
+  }
+
+  /*后台帧尚未发出即被覆盖*/
+  if (vofa->txPending) {
+    vofa->txDropped++;
+  }
+
+  memcpy(vofa->txBuf[vofa->txBack], data, 4 * vofa->txLen);
+  vofa->txPending = 1;
+
+  /*链路空闲则立即发送，否则等待发送完成回调*/
+  if (!vofa->txBusy && VOFATxSwapAndSend(vofa) != 0) {
+    return vofa_Error;
+  }
+  return vofa_Ok;
+}
+
+/**
+ * @brief 异步发送完成回调，在DMA/串口发送完成中断中调用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @note 后台有待发送的帧时立即接着发送
+ */
+void VOFATxCpltCallback(VOFAContronllerType *vofa) {
+  vofa->txBusy = 0;
+  if (vofa->txPending) {
+    VOFATxSwapAndSend(vofa);
+  }
+}
+
+/**
+ * @brief 选择VOFATxFrame使用的发送协议
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param protocol 发送协议
+ * @param precision FireWater协议的小数位数，不超过VOFA_FLOAT_PRECISION_MAX
+ * @return VOFAErrorType
+ * @note 异步双缓冲发送(VOFATxSnapshot)固定为justfloat协议
+ */
+VOFAErrorType VOFA_SetProtocol(VOFAContronllerType *vofa,
+                              VOFAProtocolType protocol, uint8_t precision) {
+  if (protocol > VOFA_RawData || precision > VOFA_FLOAT_PRECISION_MAX) {
+    return vofa_DataError;
+  }
+
+  vofa->protocol = protocol;
+  vofa->precision = precision;
   return vofa_Ok;
 }
 
 /**
- * @brief vofa发送一帧数据
+ * @brief vofa发送一帧数据，载荷与帧尾在一次TxMessage中发出
  *
  * @param vofa VOFAContronllerType类型
  * @return uint8_t
  * @note
- * 使用前务必将vofa->txFrame.fData指向要发送的数组,使用vofa->txFrame.fLen指定发送数据长度。不建议超16个，默认64个
+ * 使用前务必将vofa->txFrame.fData指向要发送的数组,使用vofa->txFrame.fLen指定发送数据长度，不超过VOFA_TX_MAX_CHANNELS。
+ * 协议由VOFA_SetProtocol选择，以下针对justfloat协议:
+ * 若数组按VOFA_TX_FRAME_FLOATS(fLen)定义并置位txFrame.tailReserved，帧尾写入数组末尾，
+ * 整帧直接从fData发送，无拷贝；否则拷贝到栈上缓冲区后发送
  */
 VOFAErrorType VOFATxFrame(VOFAContronllerType *vofa) {
-  if (vofa->txFrame.fData == NULL || vofa->txFrame.fLen > 64) {
+  if (vofa->txFrame.fData == NULL || vofa->txFrame.fLen == 0 ||
+      vofa->txFrame.fLen > VOFA_TX_MAX_CHANNELS) {
     return vofa_DataError;
   }
 
-  /*数据转换*/
   uint8_t status = 0;
-  uint8_t temp[4 * vofa->txFrame.fLen];
+  uint8_t payloadLen = 4 * vofa->txFrame.fLen;
+
+  /*文本与原始字节协议*/
+  if (vofa->protocol == VOFA_FireWater) {
+    status += VOFATxFireWater(vofa);
+    return (status != 0) ? vofa_Error : vofa_Ok;
+  }
+  if (vofa->protocol == VOFA_RawData) {
+    status += VOFATxWrite(vofa, (uint8_t *)vofa->txFrame.fData, payloadLen);
+    return (status != 0) ? vofa_Error : vofa_Ok;
+  }
 
   /*发送表征信息,vofa上位机不需要，不发送*/
   // status += vofa->TxMessage(&vofa->txFrame.fHead, 1);
   // status += vofa->TxMessage(&vofa->txFrame.fID, 1);
   // status += vofa->TxMessage(&vofa->txFrame.fLen, 1);
 
-  /*数据转换*/
-  status += Frame_float2uint8(vofa->txFrame.fData, temp, vofa->txFrame.fLen);
-  /*发送载荷数据*/
-  status += vofa->TxMessage(temp, 4 * vofa->txFrame.fLen);
-
-  /*发送帧尾*/
-  status += vofa->TxMessage((uint8_t *)fTail, 4);
+  if (vofa->txFrame.tailReserved) {
+    /*帧尾写入预留位置，整帧零拷贝发送*/
+    memcpy(&vofa->txFrame.fData[vofa->txFrame.fLen], VOFAJustFloatTail, 4);
+    status += VOFATxWrite(vofa, (uint8_t *)vofa->txFrame.fData, payloadLen + 4);
+  } else {
+    /*数据转换，拼接帧尾后一次发送*/
+    uint8_t temp[4 * VOFA_TX_FRAME_FLOATS(VOFA_TX_MAX_CHANNELS)];
+    status += Frame_float2uint8(vofa->txFrame.fData, temp, vofa->txFrame.fLen);
+    memcpy(&temp[payloadLen], VOFAJustFloatTail, 4);
+    status += VOFATxWrite(vofa, temp, payloadLen + 4);
+  }
 
   if (status != 0) {
     return vofa_Error;
@@ -83,24 +349,250 @@ VOFAErrorType VOFATxFrame(VOFAContronllerType *vofa) {
   return vofa_Ok;
 }
 
+/**
+ * @brief float按固定小数位数转为十进制字符串，不使用printf与动态内存
+ *
+ * @param value 需要转换的值
+ * @param precision 小数位数，超过VOFA_FLOAT_PRECISION_MAX时按最大值处理
+ * @param pDst 输出缓冲区，至少VOFA_FLOAT_STR_MAX个字符，不写结束符
+ * @return uint8_t 写入的字符数
+ * @note 绝对值不小于1e9时输出科学计数法(如1.2345e12)，非数与无穷输出nan/inf
+ */
+uint8_t VOFAFloatToStr(float value, uint8_t precision, char *pDst) {
+  static const uint32_t pow10[VOFA_FLOAT_PRECISION_MAX + 1] = {
+      1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+  uint8_t len = 0;
+  uint8_t exponent = 0;
+  uint32_t intPart, fracPart;
+  float absValue;
+
+  if (precision > VOFA_FLOAT_PRECISION_MAX) {
+    precision = VOFA_FLOAT_PRECISION_MAX;
+  }
+
+  /*非数*/
+  if (value != value) {
+    memcpy(pDst, "nan", 3);
+    return 3;
+  }
+
+  /*符号*/
+  if (value < 0.0f) {
+    pDst[len++] = '-';
+    absValue = -value;
+  } else {
+    absValue = value;
+  }
+
+  /*无穷*/
+  if (absValue > 3.4028235e38f) {
+    memcpy(&pDst[len], "inf", 3);
+    return len + 3;
+  }
+
+  /*超出32位整数部分的范围时归一化为科学计数法*/
+  while (absValue >= 1e9f) {
+    absValue /= 10.0f;
+    exponent++;
+  }
+  if (exponent > 0) {
+    while (absValue >= 10.0f) {
+      absValue /= 10.0f;
+      exponent++;
+    }
+  }
+
+  /*整数与小数部分，小数四舍五入并向整数进位*/
+  intPart = (uint32_t)absValue;
+  fracPart = (uint32_t)((absValue - (float)intPart) * (float)pow10[precision] +
+                        0.5f);
+  if (fracPart >= pow10[precision]) {
+    fracPart -= pow10[precision];
+    intPart++;
+  }
+  if (exponent > 0 && intPart >= 10) {
+    intPart = 1;
+    exponent++;
+  }
+
+  len += VOFAUintToStr(intPart, 1, &pDst[len]);
+  if (precision > 0) {
+    pDst[len++] = '.';
+    len += VOFAUintToStr(fracPart, precision, &pDst[len]);
+  }
+  if (exponent > 0) {
+    pDst[len++] = 'e';
+    len += VOFAUintToStr(exponent, 1, &pDst[len]);
+  }
+
+  return len;
+}
+
+/**
+ * @brief 初始化通道注册表
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param pool 通道表存储，由调用者定义并在整个使用期间有效
+ * @param poolLen 通道表容量，超出VOFA_CHANNEL_MAX时截断
+ * @return VOFAErrorType
+ */
+VOFAErrorType VOFA_ChannelInit(VOFAContronllerType *vofa,
+                               VOFAChannelType *pool, uint8_t poolLen) {
+  if (pool == NULL) {
+    return vofa_Absent;
+  }
+
+  vofa->channels = pool;
+  vofa->channelMax = (poolLen > VOFA_CHANNEL_MAX) ? VOFA_CHANNEL_MAX : poolLen;
+  vofa->channelCount = 0;
+  return vofa_Ok;
+}
+
+/**
+ * @brief 注册一个发送通道，通道号按注册顺序从0开始
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param pData 通道变量地址，发送时读取
+ * @param type 通道变量类型
+ * @param divider 分频系数，0按1处理，如控制节拍1kHz时100即10Hz
+ * @param name 通道名，可为NULL
+ * @return uint8_t 通道号，注册表已满或参数错误时为0xFF
+ * @note 同分频的通道按通道号错开起始节拍，避免低速通道集中在同一节拍发送
+ */
+uint8_t VOFA_RegisterChannel(VOFAContronllerType *vofa, const void *pData,
+                             VOFAChannelDataType type, uint16_t divider,
+                             const char *name) {
+  VOFAChannelType *ch;
+  uint8_t index = vofa->channelCount;
+
+  if (pData == NULL || vofa->channels == NULL || index >= vofa->channelMax) {
+    return 0xFF;
+  }
+
+  ch = &vofa->channels[index];
+  ch->pData = pData;
+  ch->name = name;
+  ch->type = type;
+  ch->divider = (divider == 0) ? 1 : divider;
+  ch->counter = index % ch->divider;
+  vofa->channelCount++;
+
+  return index;
+}
+
+/**
+ * @brief 发送本节拍到期的通道，每个控制节拍调用一次
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return VOFAErrorType 没有到期通道时不发送，返回vofa_Ok
+ * @note 帧格式 |VOFA_CHANNEL_HEAD|通道掩码|到期通道的float载荷|帧尾|，
+ *       掩码为(channelCount+7)/8字节小端，bit n为1表示包含通道n，载荷按通道号升序
+ */
+VOFAErrorType VOFATxChannels(VOFAContronllerType *vofa) {
+  uint8_t temp[1 + 4 + 4 * VOFA_CHANNEL_MAX + 4];
+  uint8_t maskLen = (vofa->channelCount + 7) / 8;
+  uint8_t len = 1 + maskLen;
+  uint32_t mask = 0;
+  uint8_t cnt;
+  float value;
+
+  if (vofa->channels == NULL || vofa->channelCount == 0) {
+    return vofa_DataError;
+  }
+
+  /*收集到期通道*/
+  for (cnt = 0; cnt < vofa->channelCount; cnt++) {
+    VOFAChannelType *ch = &vofa->channels[cnt];
+
+    if (ch->counter == 0) {
+      mask |= 1UL << cnt;
+      value = VOFAChannelValue(ch);
+      memcpy(&temp[len], &value, 4);
+      len += 4;
+    }
+    if (++ch->counter >= ch->divider) {
+      ch->counter = 0;
+    }
+  }
+
+  if (mask == 0) {
+    return vofa_Ok;
+  }
+
+  /*帧头、掩码与帧尾*/
+  temp[0] = VOFA_CHANNEL_HEAD;
+  for (cnt = 0; cnt < maskLen; cnt++) {
+    temp[1 + cnt] = (uint8_t)(mask >> (8 * cnt));
+  }
+  memcpy(&temp[len], VOFAJustFloatTail, 4);
+  len += 4;
+
+  return (VOFATxWrite(vofa, temp, len) != 0) ? vofa_Error : vofa_Ok;
+}
+
+/**
+ * @brief 以FireWater文本发送各通道名，"name0,name1,...\n"，供上位机解复用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return VOFAErrorType
+ * @note 未命名的通道发送为chN；建议上电后及上位机连接时发送
+ */
+VOFAErrorType VOFATxChannelNames(VOFAContronllerType *vofa) {
+  char temp[255];
+  uint8_t status = 0;
+  uint8_t len = 0;
+  uint8_t cnt, nameLen;
+
+  if (vofa->channels == NULL || vofa->channelCount == 0) {
+    return vofa_DataError;
+  }
+
+  for (cnt = 0; cnt < vofa->channelCount; cnt++) {
+    const char *name = vofa->channels[cnt].name;
+
+    /*名称最长截断为32字符，剩余空间不足时先发出*/
+    nameLen = 0;
+    if (name != NULL) {
+      while (name[nameLen] != '\0' && nameLen < 32) {
+        nameLen++;
+      }
+    }
+    if (len > sizeof(temp) - 34) {
+      status += VOFATxWrite(vofa, (uint8_t *)temp, len);
+      len = 0;
+    }
+
+    if (nameLen > 0) {
+      memcpy(&temp[len], name, nameLen);
+      len += nameLen;
+    } else {
+      temp[len++] = 'c';
+      temp[len++] = 'h';
+      len += VOFAUintToStr(cnt, 1, &temp[len]);
+    }
+    temp[len++] = (cnt + 1 < vofa->channelCount) ? ',' : '\n';
+  }
+  status += VOFATxWrite(vofa, (uint8_t *)temp, len);
+
+  return (status != 0) ? vofa_Error : vofa_Ok;
+}
+
 /**
  * @brief 从解析数据缓冲区获得需要的数据
  *
+ * @param vofa VOFAContronllerType类型地址
  * @param id 需要查询的数据对应的id
  * @return float 查询到的结果;若一直为0则错误
  */
-float VOfAReadDataFromBuffer(uint8_t id) {
-  uint8_t cnt = 0;
+float VOfAReadDataFromBuffer(VOFAContronllerType *vofa, uint8_t id) {
+  uint8_t index = vofa->rxIndex[id];
 
-  /*遍历表*/
-  for (; cnt < (sizeof(rxTable) / sizeof(VOFARxTable)); cnt++) {
-    if (id == rxTable[cnt].fID) {
-      rxTable[cnt].state = used;
-      return rxTable[cnt].data;
-    }
+  if (index == VOFA_RX_ID_NONE) {
+    return 0;
   }
 
-  return 0;
+  vofa->rxTable[index].state = VOFA_RX_USED;
+  return vofa->rxTable[index].data;
 }
 
 /**
@@ -108,50 +600,222 @@ float VOfAReadDataFromBuffer(uint8_t id) {
  *
  * @param vofa VOFAContronllerType类型地址
  * @return VOFARxState 数据接受后的处理结果
- * @note 接收的数据应为6字节。|帧头|ID|float载荷数据|
+ * @note 阻塞读取VOFA_RX_FRAME_LEN字节，要求帧对齐。|帧头|ID|float载荷数据|(校验和)|
+ *       串口中断中建议使用VOFA_RxFeed
  */
 VOFARxState VOFADecodeFrame(VOFAContronllerType *vofa) {
-
-  uint8_t tID;     // ID匹配暂存
-  uint8_t cnt = 0; // 表索引
-  uint8_t rxBytesBuf[6];
+  uint8_t rxBytesBuf[VOFA_RX_FRAME_LEN];
 
   /*获取数据*/
-  vofa->RxMessage(rxBytesBuf, 6);
-  /*转为vofa帧格式*/
-  memcpy(&vofa->rxFrame.fHead, &rxBytesBuf[0], sizeof(uint8_t));
-  memcpy(&vofa->rxFrame.fID, &rxBytesBuf[1], sizeof(uint8_t));
-  memcpy(&vofa->rxFrame.fData, &rxBytesBuf[2], sizeof(float));
+  vofa->RxMessage(rxBytesBuf, VOFA_RX_FRAME_LEN);
+
+  return VOFARxAccept(vofa, rxBytesBuf);
+}
+
+/**
+ * @brief 流式接收，逐字节组帧，可在串口IDLE/DMA中断中以任意长度的数据块调用
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param bytes 新收到的字节
+ * @param len 字节数
+ * @return uint8_t 本次成功存入缓冲表的帧数
+ * @note 帧校验失败或ID未知时计入rxErrors，并从已缓存字节中的下一个帧头重新同步，
+ *       丢字节或噪声只影响所在的帧；不足一帧的字节保留到下次调用
+ */
+uint8_t VOFA_RxFeed(VOFAContronllerType *vofa, const uint8_t *bytes,
+                    uint16_t len) {
+  uint8_t accepted = 0;
+  uint8_t i;
+
+  while (len--) {
+    uint8_t byte = *bytes++;
+
+    /*等待帧头*/
+    if (vofa->rxCount == 0 && byte != VOFA_FRAME_HEAD) {
+      continue;
+    }
+    vofa->rxStage[vofa->rxCount++] = byte;
+    if (vofa->rxCount < VOFA_RX_FRAME_LEN) {
+      continue;
+    }
+
+    /*凑满一帧*/
+    if (VOFARxAccept(vofa, vofa->rxStage) != VOFA_RX_ERROR) {
+      accepted++;
+      vofa->rxCount = 0;
+      continue;
+    }
+
+    /*重新同步: 从帧内下一个帧头开始保留*/
+    vofa->rxErrors++;
+    for (i = 1; i < VOFA_RX_FRAME_LEN; i++) {
+      if (vofa->rxStage[i] == VOFA_FRAME_HEAD) {
+        break;
+      }
+    }
+    vofa->rxCount = VOFA_RX_FRAME_LEN - i;
+    memmove(vofa->rxStage, &vofa->rxStage[i], vofa->rxCount);
+  }
+
+  return accepted;
+}
+
+/**
+ * @brief 校验一帧数据并存入缓冲配置表
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param frame VOFA_RX_FRAME_LEN字节的接收帧
+ * @return VOFARxState 帧头、校验和错误或ID未知时为VOFA_RX_ERROR
+ * @note 被覆盖的数据继续更新为最新值，状态保持VOFA_RX_COVER直到被读取
+ */
+static VOFARxState VOFARxAccept(VOFAContronllerType *vofa,
+                                const uint8_t *frame) {
+  VOFARxTable *entry;
+  uint8_t index; // 表索引
 
   /*帧头检验*/
-  if (vofa->rxFrame.fHead != VOFA_FRAME_HEAD) {
-    return error;
+  if (frame[0] != VOFA_FRAME_HEAD) {
+    return VOFA_RX_ERROR;
+  }
+
+#if VOFA_RX_CHECKSUM
+  /*校验和检验*/
+  if ((uint8_t)(frame[1] + frame[2] + frame[3] + frame[4] + frame[5]) !=
+      frame[6]) {
+    return VOFA_RX_ERROR;
   }
+#endif
 
-  tID = vofa->rxFrame.fID;
+  /*转为vofa帧格式*/
+  vofa->rxFrame.fHead = frame[0];
+  vofa->rxFrame.fID = frame[1];
+  memcpy(&vofa->rxFrame.fData, &frame[2], sizeof(float));
 
   /*ID匹配*/
-  for (; cnt < (sizeof(rxTable) / sizeof(VOFARxTable)); cnt++) {
-    /*数据状态检查*/
-    if (tID == rxTable[cnt].fID &&
-        (rxTable[cnt].state == default_init || rxTable[cnt].state == used ||
-         rxTable[cnt].state == new)) {
-      memcpy(&rxTable[cnt].data, &vofa->rxFrame.fData, sizeof(float));
-
-      /*数据覆盖判断*/
-      if (rxTable[cnt].state == new) {
-        rxTable[cnt].state = cover;
-      } else {
-        /*标记数据可用*/
-        rxTable[cnt].state = new;
-      }
+  index = vofa->rxIndex[vofa->rxFrame.fID];
+  if (index == VOFA_RX_ID_NONE) {
+    return VOFA_RX_ERROR;
+  }
+  entry = &vofa->rxTable[index];
+
+  /*数据状态检查*/
+  if (entry->state == VOFA_RX_ERROR) {
+    return VOFA_RX_ERROR;
+  }
+  entry->data = vofa->rxFrame.fData;
+  if (entry->target != NULL) {
+    *entry->target = entry->data;
+  }
+
+  /*数据覆盖判断*/
+  if (entry->state == VOFA_RX_NEW || entry->state == VOFA_RX_COVER) {
+    entry->state = VOFA_RX_COVER;
+  } else {
+    /*标记数据可用*/
+    entry->state = VOFA_RX_NEW;
+  }
+
+  /*返回处理结果*/
+  return entry->state;
+}
+
+/**
+ * @brief 交换前后台缓冲区并启动异步发送
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return uint8_t 异步发送函数的返回值，非0时该帧丢弃
+ */
+static uint8_t VOFATxSwapAndSend(VOFAContronllerType *vofa) {
+  uint8_t front = vofa->txBack;
+  uint8_t status;
+
+  vofa->txBack ^= 1;
+  vofa->txPending = 0;
+  vofa->txBusy = 1;
 
-      /*返回处理结果*/
-      return rxTable[cnt].state;
+  status = vofa->TxMessageAsync((uint8_t *)vofa->txBuf[front],
+                                4 * VOFA_TX_FRAME_FLOATS(vofa->txLen));
+  if (status != 0) {
+    vofa->txBusy = 0;
+    vofa->txDropped++;
+  }
+  return status;
+}
+
+/**
+ * @brief 以FireWater协议发送txFrame，格式为"ch0,ch1,...\n"
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @return uint8_t 发送函数返回值之和
+ * @note 直接格式化到发送缓冲区，超过一次发送的长度上限时分段发送
+ */
+static uint8_t VOFATxFireWater(VOFAContronllerType *vofa) {
+  char temp[255];
+  uint8_t status = 0;
+  uint8_t len = 0;
+  uint8_t cnt;
+
+  for (cnt = 0; cnt < vofa->txFrame.fLen; cnt++) {
+    /*剩余空间不足一个数值时先发出已格式化的部分*/
+    if (len > sizeof(temp) - (VOFA_FLOAT_STR_MAX + 1)) {
+      status += VOFATxWrite(vofa, (uint8_t *)temp, len);
+      len = 0;
     }
+    len += VOFAFloatToStr(vofa->txFrame.fData[cnt], vofa->precision,
+                          &temp[len]);
+    temp[len++] = (cnt + 1 < vofa->txFrame.fLen) ? ',' : '\n';
+  }
+  status += VOFATxWrite(vofa, (uint8_t *)temp, len);
+
+  return status;
+}
+
+/**
+ * @brief 按通道类型读取通道变量并转换为float
+ *
+ * @param ch 通道
+ * @return float 通道值
+ */
+static float VOFAChannelValue(const VOFAChannelType *ch) {
+  switch (ch->type) {
+  case VOFA_CH_Int32:
+    return (float)*(const int32_t *)ch->pData;
+  case VOFA_CH_Int16:
+    return (float)*(const int16_t *)ch->pData;
+  case VOFA_CH_Uint16:
+    return (float)*(const uint16_t *)ch->pData;
+  case VOFA_CH_Uint8:
+    return (float)*(const uint8_t *)ch->pData;
+  case VOFA_CH_Float:
+  default:
+    return *(const float *)ch->pData;
   }
+}
+
+/**
+ * @brief 无符号整数转十进制字符串
+ *
+ * @param value 需要转换的值
+ * @param minDigits 最少位数，不足时高位补0
+ * @param pDst 输出缓冲区，不写结束符
+ * @return uint8_t 写入的字符数
+ */
+static uint8_t VOFAUintToStr(uint32_t value, uint8_t minDigits,
+                             char *pDst) {
+  char digits[10];
+  uint8_t len = 0;
+  uint8_t cnt;
 
-  return error;
+  /*由低位到高位取出各位*/
+  do {
+    digits[len++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value != 0 || len < minDigits);
+
+  for (cnt = 0; cnt < len; cnt++) {
+    pDst[cnt] = digits[len - 1 - cnt];
+  }
+  return len;
 }
 
 /**
@@ -4,10 +4,32 @@
 /*std*/
 #include <stdint.h>
 
-// vofa使用justfloat协议通信时的帧尾
-const uint8_t fTail[4] = {0x00, 0x00, 0x80, 0x7f};
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// vofa使用justfloat协议通信时的帧尾，定义于vofa.c
+extern const uint8_t VOFAJustFloatTail[4];
 // 接收验证帧头，自定义
 #define VOFA_FRAME_HEAD 0x66
+// 接收帧是否带校验和(ID与4字节载荷的8位累加和，位于帧末)
+#ifndef VOFA_RX_CHECKSUM
+#define VOFA_RX_CHECKSUM 0
+#endif
+// 接收帧长度 |帧头|ID|float载荷数据|(校验和)|
+#define VOFA_RX_FRAME_LEN (6 + VOFA_RX_CHECKSUM)
+// 单帧最多发送的float个数，载荷加帧尾需不超过255字节(TxMessage长度为uint8_t)
+#define VOFA_TX_MAX_CHANNELS 62
+// 预留帧尾时发送数组需要的float个数
+#define VOFA_TX_FRAME_FLOATS(n) ((n) + 1)
+// 通道注册表帧头，|帧头|通道掩码|float载荷|帧尾|
+#define VOFA_CHANNEL_HEAD 0xA5
+// 通道注册表的通道数上限(掩码为32位)
+#define VOFA_CHANNEL_MAX 32
+// VOFAFloatToStr输出的最大字符数(不含结束符)
+#define VOFA_FLOAT_STR_MAX 20
+// FireWater协议的最大小数位数
+#define VOFA_FLOAT_PRECISION_MAX 7
 
 /*vofa错误类型*/
 typedef enum {
@@ -18,19 +40,27 @@ typedef enum {
   vofa_DataError,
 } VOFAErrorType;
 
+/*vofa发送协议*/
+typedef enum {
+  VOFA_JustFloat, // 小端float + 帧尾，默认
+  VOFA_FireWater, // CSV文本，逗号分隔，换行结束
+  VOFA_RawData,   // 原始字节，不加帧尾
+} VOFAProtocolType;
+
 /*vofa接收数据的状态*/
 typedef enum {
-  new,          // 数据是新的
-  default_init, // 默认初始化
-  used,         // 数据已被使用
-  cover,        // 数据被覆盖
-  error,        // 数据错误
+  VOFA_RX_NEW,          // 数据是新的
+  VOFA_RX_DEFAULT_INIT, // 默认初始化
+  VOFA_RX_USED,         // 数据已被使用
+  VOFA_RX_COVER,        // 数据被覆盖
+  VOFA_RX_ERROR,        // 数据错误
 } VOFARxState;
 
 /*vofa发送数据帧 -- justfloat协议*/
 typedef struct {
-  uint8_t fLen; // 载荷数据长度，用于发送
-  float *fData; // 载荷数据首地址，发送用指针
+  uint8_t fLen;         // 载荷数据长度，用于发送
+  float *fData;         // 载荷数据首地址，发送用指针
+  uint8_t tailReserved; // fData在fLen之后预留了一个float，帧尾直接写入，免拷贝
 } VOFATxFrameType;
 
 /*vofa接收数据帧 -- justfloat协议*/
@@ -45,28 +75,108 @@ typedef struct {
   VOFARxState state; // 数据状态
   uint8_t fID;       // 帧ID
   float data;        // 解析的数据
+  float *target;     // 绑定的变量，非NULL时收到的数据同时直接写入，可省略
 } VOFARxTable;
 
+// 接收ID映射中表示ID未配置的值
+#define VOFA_RX_ID_NONE 0xFF
+
+/*通道数据类型，发送时统一转换为float*/
+typedef enum {
+  VOFA_CH_Float,
+  VOFA_CH_Int32,
+  VOFA_CH_Int16,
+  VOFA_CH_Uint16,
+  VOFA_CH_Uint8,
+} VOFAChannelDataType;
+
+/*注册的发送通道*/
+typedef struct {
+  const void *pData;        // 通道变量地址
+  const char *name;         // 通道名，由VOFATxChannelNames发送给上位机
+  VOFAChannelDataType type; // 通道变量类型
+  uint16_t divider;         // 分频系数，每divider个节拍发送一次
+  uint16_t counter;         // 节拍计数，为0时本节拍发送
+} VOFAChannelType;
+
+struct RingBuf; // 环形缓冲区(modules/ringbuf)
+
 /*vofa控制器类型*/
 typedef struct {
   /*data*/
   VOFATxFrameType txFrame;
   VOFARxFrameType rxFrame;
+  VOFAProtocolType protocol; // VOFATxFrame使用的发送协议
+  uint8_t precision;         // FireWater协议的小数位数
   /*function*/
   uint8_t (*TxMessage)(uint8_t *pBuff,
                        uint8_t len); // 绑定串口发送多字节数据的函数到vofa对象
   uint8_t (*RxMessage)(uint8_t *pBuff,
                        uint8_t len); // 绑定串口接收多字节的函数到vofa对象
+  /*缓冲模式(VOFA_SetBuffers)，为NULL时直接调用串口函数*/
+  struct RingBuf *txRing; // 发送缓冲，由VOFATxPump发出
+  struct RingBuf *rxRing; // 接收缓冲，由VOFA_RxPoll解析
+  /*异步双缓冲发送(VOFA_AsyncInit)*/
+  uint8_t (*TxMessageAsync)(uint8_t *pBuff,
+                            uint8_t len); // 启动DMA等异步发送，立即返回
+  float *txBuf[2];              // 乒乓缓冲区，各VOFA_TX_FRAME_FLOATS(txLen)个float
+  uint8_t txLen;                // 异步发送的通道数
+  uint8_t txBack;               // 后台缓冲区下标，另一个为发送中的前台缓冲区
+  volatile uint8_t txBusy;      // 前台缓冲区正在发送
+  volatile uint8_t txPending;   // 后台缓冲区有待发送的帧
+  volatile uint32_t txDropped;  // 发送跟不上时被覆盖丢弃的帧数
+  /*接收缓冲表，初始化时传入，按ID直接索引*/
+  VOFARxTable *rxTable; // 接收缓冲表
+  uint8_t rxTableLen;   // 表项数量
+  uint8_t rxIndex[256]; // ID到表项下标的映射，VOFA_RX_ID_NONE为未配置
+  /*通道注册表，存储由调用者提供*/
+  VOFAChannelType *channels; // 通道表
+  uint8_t channelMax;        // 通道表容量
+  uint8_t channelCount;      // 已注册的通道数
+  /*流式接收(VOFA_RxFeed)*/
+  uint8_t rxStage[VOFA_RX_FRAME_LEN]; // 未凑满一帧的字节
+  uint8_t rxCount;                    // rxStage中已有的字节数
+  uint32_t rxErrors;                  // 校验失败或ID未知而丢弃的帧数
 } VOFAContronllerType;
 
 /*需要实现的供vofa使用的串口函数接口*/
 typedef uint8_t (*VofaUartTx)(uint8_t *pBuff, uint8_t len);
 typedef uint8_t (*VofaUartRx)(uint8_t *pBuff, uint8_t len);
+typedef uint8_t (*VofaUartTxAsync)(uint8_t *pBuff, uint8_t len);
 
 /*功能函数*/
 VOFAErrorType VOFAContronllerInit(VOFAContronllerType *vofa, VofaUartTx tx,
-                                  VofaUartRx rx);
+                                  VofaUartRx rx, VOFARxTable *table,
+                                  uint8_t tableLen);
+VOFAErrorType VOFA_SetProtocol(VOFAContronllerType *vofa,
+                              VOFAProtocolType protocol, uint8_t precision);
 VOFAErrorType VOFATxFrame(VOFAContronllerType *vofa);
-float VOfAReadDataFromBuffer(uint8_t id);
+void VOFA_SetBuffers(VOFAContronllerType *vofa, struct RingBuf *txRing,
+                     struct RingBuf *rxRing);
+uint8_t VOFATxWrite(VOFAContronllerType *vofa, uint8_t *pBuff, uint8_t len);
+VOFAErrorType VOFATxPump(VOFAContronllerType *vofa);
+uint16_t VOFA_RxPush(VOFAContronllerType *vofa, const uint8_t *bytes,
+                     uint16_t len);
+uint8_t VOFA_RxPoll(VOFAContronllerType *vofa);
+uint8_t VOFAFloatToStr(float value, uint8_t precision, char *pDst);
+VOFAErrorType VOFA_AsyncInit(VOFAContronllerType *vofa, VofaUartTxAsync txAsync,
+                             float *bufA, float *bufB, uint8_t len);
+VOFAErrorType VOFATxSnapshot(VOFAContronllerType *vofa, const float *data);
+void VOFATxCpltCallback(VOFAContronllerType *vofa);
+VOFAErrorType VOFA_ChannelInit(VOFAContronllerType *vofa,
+                               VOFAChannelType *pool, uint8_t poolLen);
+uint8_t VOFA_RegisterChannel(VOFAContronllerType *vofa, const void *pData,
+                             VOFAChannelDataType type, uint16_t divider,
+                             const char *name);
+VOFAErrorType VOFATxChannels(VOFAContronllerType *vofa);
+VOFAErrorType VOFATxChannelNames(VOFAContronllerType *vofa);
+float VOfAReadDataFromBuffer(VOFAContronllerType *vofa, uint8_t id);
+VOFARxState VOFADecodeFrame(VOFAContronllerType *vofa);
+uint8_t VOFA_RxFeed(VOFAContronllerType *vofa, const uint8_t *bytes,
+                    uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
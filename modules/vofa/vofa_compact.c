@@ -0,0 +1,296 @@
+#include "vofa_compact.h"
+#include <string.h>
+
+static uint16_t VOFACompactQuantize(const VOFACompactChannel *ch,
+                                    float value); // 量化为16位码
+static float VOFACompactDequantize(const VOFACompactChannel *ch,
+                                   uint16_t code); // 16位码还原为float
+
+/**
+ * @brief 初始化压缩编码/解码器，所有通道默认为float16
+ *
+ * @param codec 编码/解码器
+ * @param count 通道数，超出VOFA_COMPACT_MAX时截断
+ * @param keyInterval 关键帧间隔，0按1处理(每帧均为关键帧，不做差分)
+ */
+void VOFA_CompactInit(VOFACompactType *codec, uint8_t count,
+                      uint8_t keyInterval) {
+  uint8_t cnt;
+
+  if (count > VOFA_COMPACT_MAX) {
+    count = VOFA_COMPACT_MAX;
+  }
+  codec->count = count;
+  codec->keyInterval = (keyInterval == 0) ? 1 : keyInterval;
+  codec->seq = 0;
+  codec->keyCount = 0;
+  codec->synced = 0;
+
+  for (cnt = 0; cnt < VOFA_COMPACT_MAX; cnt++) {
+    VOFA_CompactSetChannel(codec, cnt, VOFA_Q_Float16, 1.0f);
+  }
+}
+
+/**
+ * @brief 设置通道量化方式
+ *
+ * @param codec 编码/解码器
+ * @param index 通道号
+ * @param quant 量化方式
+ * @param scale VOFA_Q_Scaled16的缩放系数，如角度取100即0.01°分辨率、±327°范围
+ */
+void VOFA_CompactSetChannel(VOFACompactType *codec, uint8_t index,
+                            VOFAQuantType quant, float scale) {
+  VOFACompactChannel *ch = &codec->ch[index];
+
+  ch->quant = quant;
+  ch->scale = (scale != 0.0f) ? scale : 1.0f;
+  ch->invScale = 1.0f / ch->scale;
+  ch->prev = 0;
+}
+
+/**
+ * @brief 编码一帧: 量化、与上一帧差分、zigzag后按varint打包
+ *
+ * @param codec 编码器
+ * @param data 各通道数据，count个float
+ * @param pDst 输出缓冲区，至少VOFA_COMPACT_FRAME_MAX(count)字节
+ * @return uint8_t 帧长度
+ * @note 关键帧与0差分即发送绝对值，丢帧后解码端在下一个关键帧恢复；
+ *       变化缓慢的通道每个只占1字节
+ */
+uint8_t VOFACompactEncode(VOFACompactType *codec, const float *data,
+                          uint8_t *pDst) {
+  uint8_t key = (codec->keyCount == 0);
+  uint8_t len = 3;
+  uint8_t sum, cnt;
+
+  for (cnt = 0; cnt < codec->count; cnt++) {
+    VOFACompactChannel *ch = &codec->ch[cnt];
+    uint16_t code = VOFACompactQuantize(ch, data[cnt]);
+    int16_t delta = (int16_t)(code - (key ? 0 : ch->prev));
+    uint16_t zz = (uint16_t)(((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15));
+
+    ch->prev = code;
+
+    /*varint: 每字节7位，最高位表示后续还有字节*/
+    while (zz >= 0x80) {
+      pDst[len++] = (uint8_t)(zz | 0x80);
+      zz >>= 7;
+    }
+    pDst[len++] = (uint8_t)zz;
+  }
+
+  /*帧头、长度、标志与校验和*/
+  pDst[0] = VOFA_COMPACT_HEAD;
+  pDst[1] = len - 3;
+  pDst[2] = (uint8_t)((key ? VOFA_COMPACT_KEYFRAME : 0) | (codec->seq & 0x7F));
+  sum = 0;
+  for (cnt = 2; cnt < len; cnt++) {
+    sum += pDst[cnt];
+  }
+  pDst[len++] = sum;
+
+  codec->seq = (codec->seq + 1) & 0x7F;
+  if (++codec->keyCount >= codec->keyInterval) {
+    codec->keyCount = 0;
+  }
+  return len;
+}
+
+/**
+ * @brief 解码一帧，上位机工具可据此将压缩帧转回justfloat
+ *
+ * @param codec 解码器，通道配置与编码端一致
+ * @param frame 以VOFA_COMPACT_HEAD开头的完整帧，帧长为frame[1] + 4
+ * @param len 帧长度
+ * @param out 各通道数据，count个float
+ * @return VOFAErrorType vofa_DataError为帧格式或校验和错误，
+ *         vofa_Absent为丢帧后等待关键帧，此时out不更新
+ */
+VOFAErrorType VOFACompactDecode(VOFACompactType *codec, const uint8_t *frame,
+                                uint8_t len, float *out) {
+  uint8_t pos = 3;
+  uint8_t key, sum, cnt;
+
+  /*帧格式与校验和*/
+  if (len < 4 || frame[0] != VOFA_COMPACT_HEAD || frame[1] + 4 != len) {
+    return vofa_DataError;
+  }
+  sum = 0;
+  for (cnt = 2; cnt < len - 1; cnt++) {
+    sum += frame[cnt];
+  }
+  if (sum != frame[len - 1]) {
+    return vofa_DataError;
+  }
+
+  /*序号不连续时丢弃差分帧，直到下一个关键帧*/
+  key = (frame[2] & VOFA_COMPACT_KEYFRAME) != 0;
+  if (key) {
+    codec->synced = 1;
+  } else if (!codec->synced || (frame[2] & 0x7F) != codec->seq) {
+    codec->synced = 0;
+    return vofa_Absent;
+  }
+  codec->seq = (frame[2] + 1) & 0x7F;
+
+  for (cnt = 0; cnt < codec->count; cnt++) {
+    VOFACompactChannel *ch = &codec->ch[cnt];
+    uint16_t zz = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    int16_t delta;
+
+    do {
+      if (pos >= len - 1 || shift > 14) {
+        codec->synced = 0;
+        return vofa_DataError;
+      }
+      byte = frame[pos++];
+      zz |= (uint16_t)(byte & 0x7F) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+
+    delta = (int16_t)((zz >> 1) ^ (uint16_t)-(zz & 1));
+    ch->prev = (uint16_t)((key ? 0 : ch->prev) + delta);
+    out[cnt] = VOFACompactDequantize(ch, ch->prev);
+  }
+
+  return vofa_Ok;
+}
+
+/**
+ * @brief 编码一帧并经VOFATxWrite一次发出
+ *
+ * @param vofa VOFAContronllerType类型地址
+ * @param codec 编码器
+ * @param data 各通道数据，count个float
+ * @return VOFAErrorType
+ */
+VOFAErrorType VOFATxCompact(VOFAContronllerType *vofa, VOFACompactType *codec,
+                            const float *data) {
+  uint8_t temp[VOFA_COMPACT_FRAME_MAX(VOFA_COMPACT_MAX)];
+  uint8_t len;
+
+  if (data == NULL || codec->count == 0) {
+    return vofa_DataError;
+  }
+
+  len = VOFACompactEncode(codec, data, temp);
+  return (VOFATxWrite(vofa, temp, len) != 0) ? vofa_Error : vofa_Ok;
+}
+
+/**
+ * @brief float转IEEE半精度，就近舍入
+ *
+ * @param value 需要转换的值
+ * @return uint16_t 半精度位模式，超出范围为无穷，过小为非规格数或0
+ */
+uint16_t VOFAFloatToHalf(float value) {
+  uint32_t bits;
+  uint16_t sign, half;
+  int32_t exponent;
+  uint32_t mantissa;
+
+  memcpy(&bits, &value, 4);
+  sign = (uint16_t)((bits >> 16) & 0x8000);
+  exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+  mantissa = bits & 0x7FFFFF;
+
+  /*非数与无穷*/
+  if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+    return sign | 0x7E00;
+  }
+  if (exponent >= 31) {
+    return sign | 0x7C00;
+  }
+
+  /*非规格数*/
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    half = (uint16_t)(mantissa >> (14 - exponent));
+    if ((mantissa >> (13 - exponent)) & 1) {
+      half++;
+    }
+    return sign | half;
+  }
+
+  /*规格数，尾数进位可自然进入指数*/
+  half = (uint16_t)(sign | (exponent << 10) | (mantissa >> 13));
+  if (mantissa & 0x1000) {
+    half++;
+  }
+  return half;
+}
+
+/**
+ * @brief IEEE半精度转float
+ *
+ * @param half 半精度位模式
+ * @return float 转换结果
+ */
+float VOFAHalfToFloat(uint16_t half) {
+  uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1F;
+  uint32_t mantissa = half & 0x3FF;
+  uint32_t bits;
+  float value;
+
+  if (exponent == 0) {
+    /*非规格数与0: mantissa * 2^-24*/
+    value = (float)mantissa * 5.9604645e-8f;
+    return sign ? -value : value;
+  }
+  if (exponent == 31) {
+    bits = sign | 0x7F800000 | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+  }
+
+  memcpy(&value, &bits, 4);
+  return value;
+}
+
+/**
+ * @brief 按通道量化方式将float量化为16位码
+ *
+ * @param ch 通道
+ * @param value 需要量化的值
+ * @return uint16_t 量化码
+ */
+static uint16_t VOFACompactQuantize(const VOFACompactChannel *ch,
+                                    float value) {
+  float scaled;
+
+  if (ch->quant == VOFA_Q_Float16) {
+    return VOFAFloatToHalf(value);
+  }
+
+  /*缩放、四舍五入并饱和到int16*/
+  scaled = value * ch->scale;
+  scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+  if (scaled > 32767.0f)
+    scaled = 32767.0f;
+  if (scaled < -32768.0f)
+    scaled = -32768.0f;
+  return (uint16_t)(int16_t)scaled;
+}
+
+/**
+ * @brief 16位码按通道量化方式还原为float
+ *
+ * @param ch 通道
+ * @param code 量化码
+ * @return float 还原值
+ */
+static float VOFACompactDequantize(const VOFACompactChannel *ch,
+                                   uint16_t code) {
+  if (ch->quant == VOFA_Q_Float16) {
+    return VOFAHalfToFloat(code);
+  }
+  return (float)(int16_t)code * ch->invScale;
+}
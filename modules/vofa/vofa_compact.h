@@ -0,0 +1,61 @@
+#ifndef VOFA_COMPACT_H
+#define VOFA_COMPACT_H
+
+#include "vofa.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 压缩帧帧头，|帧头|长度|标志|载荷|校验和|
+#define VOFA_COMPACT_HEAD 0xA6
+// 压缩帧通道数上限
+#define VOFA_COMPACT_MAX 32
+// count个通道的压缩帧最大字节数，每通道最多3字节
+#define VOFA_COMPACT_FRAME_MAX(count) (4 + 3 * (count))
+// 标志字节中的关键帧位，其余7位为帧序号
+#define VOFA_COMPACT_KEYFRAME 0x80
+
+/*通道量化方式*/
+typedef enum {
+  VOFA_Q_Float16,  // IEEE半精度，约3位有效数字，范围±65504
+  VOFA_Q_Scaled16, // 乘以scale后取整为int16，分辨率1/scale
+} VOFAQuantType;
+
+/*压缩通道*/
+typedef struct {
+  VOFAQuantType quant; // 量化方式
+  float scale;         // VOFA_Q_Scaled16的缩放系数
+  float invScale;      // 1/scale，解码用
+  uint16_t prev;       // 上一帧的量化码
+} VOFACompactChannel;
+
+/*压缩编码/解码器，两端需以相同的通道配置初始化*/
+typedef struct {
+  VOFACompactChannel ch[VOFA_COMPACT_MAX];
+  uint8_t count;       // 通道数
+  uint8_t keyInterval; // 每keyInterval帧发送一个关键帧(绝对值)
+  uint8_t seq;         // 帧序号
+  uint8_t keyCount;    // 编码端距上一关键帧的帧数
+  uint8_t synced;      // 解码端已收到关键帧且序号连续
+} VOFACompactType;
+
+void VOFA_CompactInit(VOFACompactType *codec, uint8_t count,
+                      uint8_t keyInterval);
+void VOFA_CompactSetChannel(VOFACompactType *codec, uint8_t index,
+                            VOFAQuantType quant, float scale);
+uint8_t VOFACompactEncode(VOFACompactType *codec, const float *data,
+                          uint8_t *pDst);
+VOFAErrorType VOFACompactDecode(VOFACompactType *codec, const uint8_t *frame,
+                                uint8_t len, float *out);
+VOFAErrorType VOFATxCompact(VOFAContronllerType *vofa, VOFACompactType *codec,
+                            const float *data);
+uint16_t VOFAFloatToHalf(float value);
+float VOFAHalfToFloat(uint16_t half);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !VOFA_COMPACT_H
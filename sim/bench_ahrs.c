@@ -0,0 +1,290 @@
+/**
+ * @file bench_ahrs.c
+ * @brief 在同一组传感器日志上回放各AHRS后端，比较姿态误差与单次更新耗时
+ * @note 用法:
+ *       bench_ahrs              回放内置合成日志，误差超出阈值时返回非0
+ *       bench_ahrs log.csv      回放记录的日志，有真值列时计算误差
+ *       bench_ahrs --save path  保存内置合成日志，作为日志格式示例
+ *       日志每行: dt,ax,ay,az,gx,gy,gz,mx,my,mz[,q0,q1,q2,q3]，
+ *       陀螺仪°/s，与MahonyUpdateAHRS一致；'#'开头的行忽略
+ */
+#include "ahrs.h"
+#include "complementary.h"
+#include "eskf.h"
+#include "madgwick.h"
+#include "mahony.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+#include <string.h>
+
+/*日志长度上限*/
+#define BENCH_LOG_MAX 400000u
+/*计算误差前的收敛时间(s)*/
+#define BENCH_WARMUP 10.0f
+
+/*日志记录*/
+typedef struct {
+  float dt;        // 距上一条的时间(s)
+  MahonyInput imu; // 传感器数据，陀螺仪°/s
+  float q[4];      // 真实姿态
+} BenchSample;
+
+/*被测后端*/
+typedef struct {
+  const AHRSBackendType *backend;
+  void (*Init)(void *filter); // 初始化滤波器实体
+  float rmsLimit;             // 合成日志上均方根误差上限(°)
+  float maxLimit;             // 合成日志上最大误差上限(°)
+} BenchBackend;
+
+static BenchSample benchLog[BENCH_LOG_MAX];
+static uint32_t benchCount;
+static uint8_t benchHasTruth;
+
+static void BenchInitMahony(void *filter) {
+  MahonyFilterCoreInit((MahonyFilterType *)filter);
+}
+
+static void BenchInitMadgwick(void *filter) {
+  MadgwickFilterInit((MadgwickFilterType *)filter, 0.1f);
+}
+
+static void BenchInitComplementary(void *filter) {
+  ComplementaryFilterInit((ComplementaryFilterType *)filter, 0.005f, 0.002f);
+}
+
+static void BenchInitESKF(void *filter) {
+  const ESKFConfig config = ESKF_DEFAULT_CONFIG;
+
+  ESKFFilterInit((ESKFFilterType *)filter, &config);
+}
+
+/*上限按默认参数的实测值留余量: 线加速度段内mahony与互补滤波跟随加速度计
+  倾斜约atan(2/9.8)，madgwick不估计零偏，航向随零偏/beta存在静差*/
+static const BenchBackend benchBackends[] = {
+    {&AHRS_Mahony, BenchInitMahony, 4.5f, 15.0f},
+    {&AHRS_Madgwick, BenchInitMadgwick, 11.0f, 16.0f},
+    {&AHRS_Complementary, BenchInitComplementary, 4.5f, 15.0f},
+    {&AHRS_ESKF, BenchInitESKF, 3.0f, 7.0f},
+};
+
+/**
+ * @brief 生成合成日志: 三轴转动、陀螺仪零偏与噪声，每10 s一段1 s的线加速度
+ *
+ * @param seconds 时长(s)
+ * @param dt 采样周期(s)
+ */
+static void BenchGenerateLog(float seconds, float dt) {
+  PlantRigidBodyType body;
+  float w[3];
+  uint32_t k;
+
+  SimSeed(4);
+  PlantRigidBody_Init(&body);
+  body.gyroBias[0] = 0.01f;
+  body.gyroBias[1] = -0.02f;
+  body.gyroBias[2] = 0.005f;
+  // 初始横滚20°
+  body.q[0] = cosf(0.1745329f);
+  body.q[1] = sinf(0.1745329f);
+
+  benchCount = (uint32_t)(seconds / dt);
+  if (benchCount > BENCH_LOG_MAX) {
+    benchCount = BENCH_LOG_MAX;
+  }
+  for (k = 0; k < benchCount; k++) {
+    float t = (float)k * dt;
+    BenchSample *s = &benchLog[k];
+
+    w[0] = 0.8f * sinf(6.2831853f * 0.20f * t);
+    w[1] = 0.6f * sinf(6.2831853f * 0.13f * t + 1.0f);
+    w[2] = 0.5f * cosf(6.2831853f * 0.07f * t);
+    body.linAccel[0] = (fmodf(t, 10.0f) > 9.0f) ? 2.0f : 0.0f;
+    PlantRigidBodyStep(&body, w, dt);
+    PlantRigidBodyIMU(&body, w, &s->imu);
+
+    s->dt = dt;
+    s->imu.gyro.x *= 57.29578f;
+    s->imu.gyro.y *= 57.29578f;
+    s->imu.gyro.z *= 57.29578f;
+    memcpy(s->q, body.q, sizeof(s->q));
+  }
+  benchHasTruth = 1;
+}
+
+/**
+ * @brief 读取CSV日志
+ *
+ * @param path 文件路径
+ * @return int 0为成功
+ */
+static int BenchLoadLog(const char *path) {
+  FILE *fp = fopen(path, "r");
+  char line[512];
+  int fields;
+
+  if (fp == NULL) {
+    printf("cannot open %s\n", path);
+    return 1;
+  }
+
+  benchCount = 0;
+  benchHasTruth = 1;
+  while ((benchCount < BENCH_LOG_MAX) && fgets(line, sizeof(line), fp)) {
+    BenchSample *s = &benchLog[benchCount];
+
+    if ((line[0] == '#') || (line[0] == '\n')) {
+      continue;
+    }
+    fields = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f", &s->dt,
+                    &s->imu.accel.x, &s->imu.accel.y, &s->imu.accel.z,
+                    &s->imu.gyro.x, &s->imu.gyro.y, &s->imu.gyro.z,
+                    &s->imu.mag.x, &s->imu.mag.y, &s->imu.mag.z, &s->q[0],
+                    &s->q[1], &s->q[2], &s->q[3]);
+    if (fields < 10) {
+      continue;
+    }
+    if (fields < 14) {
+      benchHasTruth = 0;
+    }
+    s->imu.timestamp = 0;
+    benchCount++;
+  }
+  fclose(fp);
+
+  printf("loaded %u samples from %s%s\n", benchCount, path,
+         benchHasTruth ? "" : " (no truth, timing only)");
+  return (benchCount == 0);
+}
+
+/**
+ * @brief 保存日志为CSV
+ *
+ * @param path 文件路径
+ * @return int 0为成功
+ */
+static int BenchSaveLog(const char *path) {
+  FILE *fp = fopen(path, "w");
+  uint32_t k;
+
+  if (fp == NULL) {
+    printf("cannot open %s\n", path);
+    return 1;
+  }
+  fprintf(fp, "# dt,ax,ay,az,gx,gy,gz,mx,my,mz,q0,q1,q2,q3 "
+              "(s, m/s^2, deg/s, uT, truth)\n");
+  for (k = 0; k < benchCount; k++) {
+    const BenchSample *s = &benchLog[k];
+
+    fprintf(fp, "%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.7g,%.7g,"
+                "%.7g,%.7g\n",
+            s->dt, s->imu.accel.x, s->imu.accel.y, s->imu.accel.z,
+            s->imu.gyro.x, s->imu.gyro.y, s->imu.gyro.z, s->imu.mag.x,
+            s->imu.mag.y, s->imu.mag.z, s->q[0], s->q[1], s->q[2], s->q[3]);
+  }
+  fclose(fp);
+  printf("saved %u samples to %s\n", benchCount, path);
+  return 0;
+}
+
+/**
+ * @brief 回放日志: 一遍计算误差，一遍单独计时
+ *
+ * @param b 被测后端
+ * @param check 1为按阈值检查误差
+ */
+static void BenchReplay(const BenchBackend *b, uint8_t check) {
+  union {
+    MahonyFilterType mahony;
+    MadgwickFilterType madgwick;
+    ComplementaryFilterType complementary;
+    ESKFFilterType eskf;
+  } filter;
+  AHRSObjectType ahrs;
+  MahonyInput imu;
+  double sumAtt = 0.0, sumTilt = 0.0;
+  float maxAtt = 0.0f, elapsed = 0.0f, err;
+  uint32_t k, used = 0;
+  uint64_t t0, c0, ns, cycles;
+
+  b->Init(&filter);
+  AHRS_ObjectInit(&ahrs, b->backend, &filter);
+  for (k = 0; k < benchCount; k++) {
+    const BenchSample *s = &benchLog[k];
+
+    imu = s->imu;
+    AHRSUpdate(&ahrs, &imu, s->dt);
+    elapsed += s->dt;
+    if (!benchHasTruth || (elapsed < BENCH_WARMUP)) {
+      continue;
+    }
+    err = SimQuatAngle(s->q, AHRSGetQuaternion(&ahrs)) * 57.29578f;
+    sumAtt += (double)err * err;
+    if (err > maxAtt) {
+      maxAtt = err;
+    }
+    err = SimTiltAngle(s->q, AHRSGetQuaternion(&ahrs)) * 57.29578f;
+    sumTilt += (double)err * err;
+    used++;
+  }
+
+  // 计时，接口会就地修改输入，每次调用前拷贝
+  b->Init(&filter);
+  t0 = SimNowNs();
+  c0 = SimCycles();
+  for (k = 0; k < benchCount; k++) {
+    imu = benchLog[k].imu;
+    AHRSUpdate(&ahrs, &imu, benchLog[k].dt);
+  }
+  cycles = SimCycles() - c0;
+  ns = SimNowNs() - t0;
+  SIM_KEEP(AHRSGetQuaternion(&ahrs)[0]);
+
+  if (used == 0) {
+    printf("%-14s %9s %9s %9s", b->backend->name, "-", "-", "-");
+  } else {
+    printf("%-14s %9.3f %9.3f %9.3f", b->backend->name,
+           sqrt(sumAtt / used), maxAtt, sqrt(sumTilt / used));
+  }
+  printf(" %10.1f", (double)ns / benchCount);
+  if (SIM_HAVE_CYCLES) {
+    printf(" %10.1f\n", (double)cycles / benchCount);
+  } else {
+    printf(" %10s\n", "-");
+  }
+
+  if (check && (used != 0)) {
+    SIM_CHECK(sqrt(sumAtt / used) < b->rmsLimit, "%s rms error %.3f deg",
+              b->backend->name, sqrt(sumAtt / used));
+    SIM_CHECK(maxAtt < b->maxLimit, "%s max error %.3f deg",
+              b->backend->name, maxAtt);
+  }
+}
+
+int main(int argc, char **argv) {
+  uint8_t check = 1;
+  uint32_t k;
+
+  if ((argc == 3) && (strcmp(argv[1], "--save") == 0)) {
+    BenchGenerateLog(60.0f, 0.001f);
+    return BenchSaveLog(argv[2]);
+  }
+  if (argc == 2) {
+    if (BenchLoadLog(argv[1]) != 0) {
+      return 1;
+    }
+    check = 0;
+  } else {
+    BenchGenerateLog(60.0f, 0.001f);
+    printf("synthetic log: %u samples at 1 kHz\n", benchCount);
+  }
+
+  printf("%-14s %9s %9s %9s %10s %10s\n", "backend", "rms[deg]", "max[deg]",
+         "tilt[deg]", "ns/update", "tsc/update");
+  for (k = 0; k < sizeof(benchBackends) / sizeof(benchBackends[0]); k++) {
+    BenchReplay(&benchBackends[k], check);
+  }
+
+  return simFailures != 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file bench_eskf.c
+ * @brief ESKF单次更新的周期数与耗时，及陀螺仪温漂下的零偏跟踪
+ * @note 周期数为主机TSC计数，只用于同一机器上对比mahony，ns含逐次计时开销；
+ *       零偏或姿态误差超出阈值时返回非0
+ */
+#include "eskf.h"
+#include "mahony.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+#include <stdlib.h>
+
+/*逐次计时的调用次数*/
+#define BENCH_CALLS 200000u
+/*温漂场景: 零偏在BENCH_RAMP_TIME内线性升到终值，之后保持*/
+#define BENCH_DRIFT_TIME 120.0f
+#define BENCH_RAMP_TIME 90.0f
+
+static MahonyInput benchInput[1024];
+static uint64_t benchSample[BENCH_CALLS];
+
+static int BenchCompare(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief 逐次计时，输出最小值、中位数与99%分位
+ *
+ * @param name 名称
+ * @param update 更新函数
+ * @param filter 滤波器实体
+ */
+static void BenchCycles(const char *name,
+                        void (*update)(void *, MahonyInput *, float),
+                        void *filter) {
+  MahonyInput imu;
+  uint64_t t0, c0, total;
+  uint32_t k;
+
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_CALLS; k++) {
+    imu = benchInput[k & 1023u];
+    c0 = SimCycles();
+    update(filter, &imu, 0.001f);
+    benchSample[k] = SimCycles() - c0;
+  }
+  total = SimNowNs() - t0;
+
+  qsort(benchSample, BENCH_CALLS, sizeof(benchSample[0]), BenchCompare);
+  printf("%-20s %8.1f ns", name, (double)total / BENCH_CALLS);
+  if (SIM_HAVE_CYCLES) {
+    printf("  tsc min %5u  median %5u  p99 %5u\n", (unsigned)benchSample[0],
+           (unsigned)benchSample[BENCH_CALLS / 2],
+           (unsigned)benchSample[BENCH_CALLS * 99 / 100]);
+  } else {
+    printf("\n");
+  }
+}
+
+static void BenchESKFAHRS(void *f, MahonyInput *in, float dt) {
+  ESKFUpdateAHRS((ESKFFilterType *)f, in, dt);
+}
+
+static void BenchESKFIMU(void *f, MahonyInput *in, float dt) {
+  ESKFUpdateAHRSIMU((ESKFFilterType *)f, in, dt);
+}
+
+static void BenchMahonyAHRS(void *f, MahonyInput *in, float dt) {
+  MahonyUpdateAHRS((MahonyFilterType *)f, in, dt);
+}
+
+static void BenchMahonyIMU(void *f, MahonyInput *in, float dt) {
+  MahonyUpdateAHRSIMU((MahonyFilterType *)f, in, dt);
+}
+
+/**
+ * @brief 各更新接口的单次耗时，输入取自刚体仿真
+ */
+static void BenchSpeed(void) {
+  const ESKFConfig config = ESKF_DEFAULT_CONFIG;
+  PlantRigidBodyType body;
+  ESKFFilterType eskf;
+  MahonyFilterType mahony;
+  float w[3];
+  uint32_t k;
+
+  SimSeed(5);
+  PlantRigidBody_Init(&body);
+  for (k = 0; k < 1024; k++) {
+    w[0] = 0.5f * sinf(0.01f * k);
+    w[1] = 0.3f;
+    w[2] = -0.2f;
+    PlantRigidBodyStep(&body, w, 0.001f);
+    PlantRigidBodyIMU(&body, w, &benchInput[k]);
+  }
+
+  // AHRS接口陀螺仪为°/s，AHRSIMU接口为rad/s，两组各用一种单位
+  ESKFFilterInit(&eskf, &config);
+  BenchCycles("eskf AHRSIMU", BenchESKFIMU, &eskf);
+  MahonyFilterCoreInit(&mahony);
+  BenchCycles("mahony AHRSIMU", BenchMahonyIMU, &mahony);
+
+  for (k = 0; k < 1024; k++) {
+    benchInput[k].gyro.x *= 57.29578f;
+    benchInput[k].gyro.y *= 57.29578f;
+    benchInput[k].gyro.z *= 57.29578f;
+  }
+  ESKFFilterInit(&eskf, &config);
+  BenchCycles("eskf AHRS", BenchESKFAHRS, &eskf);
+  MahonyFilterCoreInit(&mahony);
+  BenchCycles("mahony AHRS", BenchMahonyAHRS, &mahony);
+}
+
+/**
+ * @brief 陀螺仪零偏随温度线性漂移，比较ESKF与mahony的零偏估计和姿态误差
+ */
+static void BenchDrift(void) {
+  const ESKFConfig config = ESKF_DEFAULT_CONFIG;
+  const float biasEnd[3] = {0.03f, -0.04f, 0.02f};
+  const float dt = 0.001f;
+  PlantRigidBodyType body;
+  ESKFFilterType eskf;
+  MahonyFilterType mahony;
+  MahonyInput imu, copy;
+  float w[3], q[4], err;
+  float eskfBias = 0.0f, mahonyBias = 0.0f, eskfMax = 0.0f, mahonyMax = 0.0f;
+  double eskfSum = 0.0, mahonySum = 0.0;
+  uint32_t k, used = 0;
+  uint8_t i;
+
+  SimSeed(6);
+  PlantRigidBody_Init(&body);
+  ESKFFilterInit(&eskf, &config);
+  MahonyFilterCoreInit(&mahony);
+
+  for (k = 0; k < (uint32_t)(BENCH_DRIFT_TIME / dt); k++) {
+    float t = (float)k * dt;
+    float ramp = (t < BENCH_RAMP_TIME) ? t / BENCH_RAMP_TIME : 1.0f;
+
+    for (i = 0; i < 3; i++) {
+      body.gyroBias[i] = biasEnd[i] * ramp;
+    }
+    w[0] = 0.6f * sinf(6.2831853f * 0.15f * t);
+    w[1] = 0.4f * sinf(6.2831853f * 0.11f * t + 1.0f);
+    w[2] = 0.3f * cosf(6.2831853f * 0.05f * t);
+    PlantRigidBodyStep(&body, w, dt);
+    PlantRigidBodyIMU(&body, w, &imu);
+    imu.gyro.x *= 57.29578f;
+    imu.gyro.y *= 57.29578f;
+    imu.gyro.z *= 57.29578f;
+
+    copy = imu;
+    ESKFUpdateAHRS(&eskf, &copy, dt);
+    copy = imu;
+    MahonyUpdateAHRS(&mahony, &copy, dt);
+
+    if (t < 10.0f) {
+      continue;
+    }
+    err = SimQuatAngle(body.q, eskf.q) * 57.29578f;
+    eskfSum += (double)err * err;
+    eskfMax = (err > eskfMax) ? err : eskfMax;
+    MahonyGetQuaternion(&mahony, q);
+    err = SimQuatAngle(body.q, q) * 57.29578f;
+    mahonySum += (double)err * err;
+    mahonyMax = (err > mahonyMax) ? err : mahonyMax;
+    used++;
+  }
+
+  // mahony的积分项与零偏反号
+  for (i = 0; i < 3; i++) {
+    err = fabsf(eskf.bias[i] - body.gyroBias[i]);
+    eskfBias = (err > eskfBias) ? err : eskfBias;
+    err = fabsf(-mahony.filter.integralFB[i] - body.gyroBias[i]);
+    mahonyBias = (err > mahonyBias) ? err : mahonyBias;
+  }
+
+  printf("drift eskf   attitude rms %.3f max %.3f deg  final bias error "
+         "%.5f rad/s\n",
+         sqrt(eskfSum / used), eskfMax, eskfBias);
+  printf("drift mahony attitude rms %.3f max %.3f deg  final bias error "
+         "%.5f rad/s\n",
+         sqrt(mahonySum / used), mahonyMax, mahonyBias);
+  SIM_CHECK(eskfBias < 0.003f, "eskf bias error %.4f rad/s", eskfBias);
+  SIM_CHECK(eskfBias < mahonyBias, "eskf bias error %.5f >= mahony %.5f",
+            eskfBias, mahonyBias);
+  SIM_CHECK(sqrt(eskfSum / used) < 0.8, "eskf rms error %.3f deg",
+            sqrt(eskfSum / used));
+  SIM_CHECK(eskfMax < 1.5f, "eskf max error %.3f deg", eskfMax);
+}
+
+int main(void) {
+  BenchSpeed();
+  BenchDrift();
+
+  return simFailures != 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file bench_invsqrt.c
+ * @brief MahonyInvSqrt内核的精度、耗时与姿态解算结果
+ * @note 每种MAHONY_INVSQRT_KERNEL单独编译一个程序(bench_invsqrt_hw等)；
+ *       相对误差超出内核标称上限或姿态误差过大时返回非0
+ */
+#include "mahony.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+
+#if (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_HW)
+#define BENCH_KERNEL_NAME "hw"
+#define BENCH_REL_ERROR_MAX 3e-7 // 1.0f/sqrtf两次舍入
+#elif (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_NEWTON)
+#define BENCH_KERNEL_NAME "newton"
+#define BENCH_REL_ERROR_MAX 1.8e-3 // 魔数初值加一次牛顿迭代
+#elif (MAHONY_INVSQRT_KERNEL == MAHONY_INVSQRT_SSE)
+#define BENCH_KERNEL_NAME "sse"
+#define BENCH_REL_ERROR_MAX 5e-7 // rsqrtss 12bit初值加一次牛顿迭代
+#endif
+
+/*精度扫描与耗时测试的输入个数，按对数均匀分布在[1e-6, 1e6]*/
+#define BENCH_POINTS 1000000u
+#define BENCH_ROUNDS 20u
+
+static float benchX[BENCH_POINTS];
+static float benchY[BENCH_POINTS];
+
+/**
+ * @brief 对数均匀扫描，与双精度参考比较相对误差
+ */
+static void BenchAccuracy(void) {
+  double maxRel = 0.0, sumSq = 0.0;
+  float worstX = 0.0f;
+  uint32_t k;
+
+  for (k = 0; k < BENCH_POINTS; k++) {
+    double ref = 1.0 / sqrt((double)benchX[k]);
+    double rel = fabs((double)MahonyInvSqrt(benchX[k]) - ref) / ref;
+
+    sumSq += rel * rel;
+    if (rel > maxRel) {
+      maxRel = rel;
+      worstX = benchX[k];
+    }
+  }
+
+  printf("invsqrt %-7s rel error max %.3e (x = %.4g)  rms %.3e\n",
+         BENCH_KERNEL_NAME, maxRel, worstX, sqrt(sumSq / BENCH_POINTS));
+  SIM_CHECK(maxRel < BENCH_REL_ERROR_MAX, "max relative error %.3e > %.1e",
+            maxRel, BENCH_REL_ERROR_MAX);
+}
+
+/**
+ * @brief 吞吐(输入互相独立)与延迟(每次输入依赖上次结果)
+ */
+static void BenchSpeed(void) {
+  float y = 1.0f;
+  uint64_t t0;
+  uint32_t r, k;
+
+  t0 = SimNowNs();
+  for (r = 0; r < BENCH_ROUNDS; r++) {
+    for (k = 0; k < BENCH_POINTS; k++) {
+      benchY[k] = MahonyInvSqrt(benchX[k]);
+    }
+    SIM_KEEP(benchY[r]);
+  }
+  printf("invsqrt %-7s throughput %6.2f ns/call\n", BENCH_KERNEL_NAME,
+         (double)(SimNowNs() - t0) / ((double)BENCH_ROUNDS * BENCH_POINTS));
+
+  // y在1附近的不动点上迭代，每次调用都要等上一次的结果
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_ROUNDS * BENCH_POINTS / 4; k++) {
+    y = MahonyInvSqrt(y * y + 1e-3f);
+  }
+  SIM_KEEP(y);
+  printf("invsqrt %-7s latency    %6.2f ns/call\n", BENCH_KERNEL_NAME,
+         (double)(SimNowNs() - t0) /
+             ((double)BENCH_ROUNDS * BENCH_POINTS / 4));
+}
+
+/**
+ * @brief 用该内核跑九轴mahony，确认主机上解算出的姿态正确
+ */
+static void BenchAttitude(void) {
+  PlantRigidBodyType body;
+  MahonyFilterType ahrs;
+  MahonyInput imu;
+  const float dt = 0.001f;
+  float w[3], q[4], err, maxErr = 0.0f;
+  uint32_t k;
+
+  SimSeed(3);
+  PlantRigidBody_Init(&body);
+  MahonyFilterCoreInit(&ahrs);
+
+  for (k = 0; k < 30000; k++) {
+    float t = (float)k * dt;
+
+    w[0] = 0.7f * sinf(1.3f * t);
+    w[1] = 0.5f * sinf(0.9f * t + 0.5f);
+    w[2] = 0.4f * cosf(0.4f * t);
+    PlantRigidBodyStep(&body, w, dt);
+    PlantRigidBodyIMU(&body, w, &imu);
+    imu.gyro.x *= 57.29578f;
+    imu.gyro.y *= 57.29578f;
+    imu.gyro.z *= 57.29578f;
+    MahonyUpdateAHRS(&ahrs, &imu, dt);
+
+    if (k >= 5000) {
+      MahonyGetQuaternion(&ahrs, q);
+      err = SimQuatAngle(body.q, q) * 57.29578f;
+      if (err > maxErr) {
+        maxErr = err;
+      }
+    }
+  }
+
+  printf("invsqrt %-7s mahony MARG max attitude error %.3f deg\n",
+         BENCH_KERNEL_NAME, maxErr);
+  SIM_CHECK(maxErr < 3.0f, "attitude error %.3f deg", maxErr);
+}
+
+int main(void) {
+  uint32_t k;
+
+  for (k = 0; k < BENCH_POINTS; k++) {
+    benchX[k] = (float)pow(10.0, -6.0 + 12.0 * k / (BENCH_POINTS - 1));
+  }
+
+  BenchAccuracy();
+  BenchSpeed();
+  BenchAttitude();
+
+  return simFailures != 0;
+}
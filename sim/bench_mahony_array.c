@@ -0,0 +1,167 @@
+/**
+ * @file bench_mahony_array.c
+ * @brief 多实例mahony(SoA)与N次标量mahony更新的结果一致性与耗时
+ * @note 两者四元数偏差超出上限时返回非0；SoA耗时含MahonyArraySetInput打包
+ */
+#include "mahony.h"
+#include "mahony_array.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+
+/*输入表长度与一致性检查时长(步)*/
+#define BENCH_TABLE 1024u
+#define BENCH_STEPS 10000u
+#define BENCH_ROUNDS 200u
+/*四元数分量最大偏差上限*/
+#define BENCH_Q_ERROR_MAX 1e-5f
+
+/*陀螺仪rad/s，供SoA与AHRSIMU接口使用*/
+static MahonyInput benchInput[BENCH_TABLE][MAHONY_ARRAY_MAX];
+/*同一数据陀螺仪换算为°/s，供MahonyUpdateAHRS使用*/
+static MahonyInput benchInputDeg[BENCH_TABLE][MAHONY_ARRAY_MAX];
+
+/**
+ * @brief 每个IMU对应一个转速不同的刚体
+ */
+static void BenchGenerate(void) {
+  PlantRigidBodyType body[MAHONY_ARRAY_MAX];
+  float w[3];
+  uint32_t k;
+  uint8_t n;
+
+  SimSeed(8);
+  for (n = 0; n < MAHONY_ARRAY_MAX; n++) {
+    PlantRigidBody_Init(&body[n]);
+    body[n].gyroBias[0] = 0.005f * n;
+  }
+  for (k = 0; k < BENCH_TABLE; k++) {
+    for (n = 0; n < MAHONY_ARRAY_MAX; n++) {
+      float t = (float)k * 0.001f;
+
+      w[0] = (0.3f + 0.1f * n) * sinf(6.2831853f * 0.5f * t);
+      w[1] = 0.4f * cosf(6.2831853f * 0.3f * t + n);
+      w[2] = 0.2f + 0.05f * n;
+      PlantRigidBodyStep(&body[n], w, 0.001f);
+      PlantRigidBodyIMU(&body[n], w, &benchInput[k][n]);
+      benchInputDeg[k][n] = benchInput[k][n];
+      benchInputDeg[k][n].gyro.x *= 57.29578f;
+      benchInputDeg[k][n].gyro.y *= 57.29578f;
+      benchInputDeg[k][n].gyro.z *= 57.29578f;
+    }
+  }
+}
+
+/**
+ * @brief 同一输入分别送入SoA与标量实现，比较四元数，并计时
+ *
+ * @param count 同时解算的IMU数量
+ * @param useMag 1为九轴，0为六轴
+ */
+static void BenchCompare(uint8_t count, uint8_t useMag) {
+  const MahonyConfig config = MAHONY_DEFAULT_CONFIG;
+  MahonyArrayType arr;
+  MahonyArrayInput in;
+  MahonyFilterType ahrs[MAHONY_ARRAY_MAX];
+  MahonyInput imu;
+  float qa[4], qs[4], err, maxErr = 0.0f;
+  uint64_t t0, nsArray, nsScalar;
+  uint32_t k;
+  uint8_t n, i;
+
+  MahonyArrayInit(&arr, count, &config);
+  for (n = 0; n < count; n++) {
+    MahonyFilterInit(&ahrs[n], &config);
+  }
+  // 未使用的通道也要有合法输入
+  for (n = 0; n < MAHONY_ARRAY_MAX; n++) {
+    MahonyArraySetInput(&in, n, &benchInput[0][n]);
+  }
+
+  for (k = 0; k < BENCH_STEPS; k++) {
+    const MahonyInput *row = benchInput[k % BENCH_TABLE];
+    const MahonyInput *rowDeg = benchInputDeg[k % BENCH_TABLE];
+
+    for (n = 0; n < count; n++) {
+      MahonyArraySetInput(&in, n, &row[n]);
+      if (useMag) {
+        imu = rowDeg[n];
+        MahonyUpdateAHRS(&ahrs[n], &imu, 0.001f);
+      } else {
+        imu = row[n];
+        MahonyUpdateAHRSIMU(&ahrs[n], &imu, 0.001f);
+      }
+    }
+    if (useMag) {
+      MahonyArrayUpdateAHRS(&arr, &in, 0.001f);
+    } else {
+      MahonyArrayUpdateAHRSIMU(&arr, &in, 0.001f);
+    }
+  }
+  for (n = 0; n < count; n++) {
+    MahonyArrayGetQuaternion(&arr, n, qa);
+    MahonyGetQuaternion(&ahrs[n], qs);
+    for (i = 0; i < 4; i++) {
+      err = fabsf(qa[i] - qs[i]);
+      maxErr = (err > maxErr) ? err : maxErr;
+    }
+  }
+
+  // 计时，标量接口会就地修改输入，每次调用前拷贝
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_ROUNDS * BENCH_TABLE; k++) {
+    const MahonyInput *row = benchInput[k % BENCH_TABLE];
+
+    for (n = 0; n < count; n++) {
+      MahonyArraySetInput(&in, n, &row[n]);
+    }
+    if (useMag) {
+      MahonyArrayUpdateAHRS(&arr, &in, 0.001f);
+    } else {
+      MahonyArrayUpdateAHRSIMU(&arr, &in, 0.001f);
+    }
+  }
+  nsArray = SimNowNs() - t0;
+  SIM_KEEP(arr.q0[0]);
+
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_ROUNDS * BENCH_TABLE; k++) {
+    const MahonyInput *row =
+        useMag ? benchInputDeg[k % BENCH_TABLE] : benchInput[k % BENCH_TABLE];
+
+    for (n = 0; n < count; n++) {
+      imu = row[n];
+      if (useMag) {
+        MahonyUpdateAHRS(&ahrs[n], &imu, 0.001f);
+      } else {
+        MahonyUpdateAHRSIMU(&ahrs[n], &imu, 0.001f);
+      }
+    }
+  }
+  nsScalar = SimNowNs() - t0;
+  SIM_KEEP(ahrs[0].filter.q[0]);
+
+  printf("%s N=%u  soa %7.1f ns  scalar %7.1f ns  speedup %4.2f  "
+         "max |dq| %.2e\n",
+         useMag ? "AHRS   " : "AHRSIMU", count,
+         (double)nsArray / (BENCH_ROUNDS * BENCH_TABLE),
+         (double)nsScalar / (BENCH_ROUNDS * BENCH_TABLE),
+         (double)nsScalar / (double)nsArray, maxErr);
+  SIM_CHECK(maxErr < BENCH_Q_ERROR_MAX, "N=%u %s max |dq| %.2e", count,
+            useMag ? "AHRS" : "AHRSIMU", maxErr);
+}
+
+int main(void) {
+  static const uint8_t counts[] = {1, 2, 4, MAHONY_ARRAY_MAX};
+  uint8_t k;
+
+  BenchGenerate();
+  for (k = 0; k < sizeof(counts); k++) {
+    BenchCompare(counts[k], 0);
+  }
+  for (k = 0; k < sizeof(counts); k++) {
+    BenchCompare(counts[k], 1);
+  }
+
+  return simFailures != 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file bench_pid_bank.c
+ * @brief pid组(SoA)与逐通道PIDUpdate的输出一致性、冻结通道的NaN隔离与耗时
+ * @note 输出偏差超出上限或冻结通道状态被改写时返回非0
+ */
+#include "pid.h"
+#include "pid_bank.h"
+#include "sim.h"
+#include <math.h>
+#include <string.h>
+
+/*误差表长度与一致性检查步数*/
+#define BENCH_TABLE 1024u
+#define BENCH_STEPS 20000u
+#define BENCH_ROUNDS 200u
+/*输出偏差上限(相对输出限幅)*/
+#define BENCH_OUT_ERROR_MAX 1e-5f
+
+static float benchError[BENCH_TABLE][PID_BANK_MAX];
+
+/**
+ * @brief 各通道误差为带界随机游走，足以进入限幅与积分限幅
+ */
+static void BenchGenerate(void) {
+  float e[PID_BANK_MAX] = {0};
+  uint32_t k;
+  uint8_t ch;
+
+  SimSeed(9);
+  for (k = 0; k < BENCH_TABLE; k++) {
+    for (ch = 0; ch < PID_BANK_MAX; ch++) {
+      e[ch] += 0.2f * SimRandn();
+      e[ch] = (e[ch] > 5.0f) ? 5.0f : ((e[ch] < -5.0f) ? -5.0f : e[ch]);
+      benchError[k][ch] = e[ch];
+    }
+  }
+}
+
+/**
+ * @brief 两种实现用相同增益初始化
+ *
+ * @param bank pid组
+ * @param pid 逐通道pid
+ * @param count 通道数量
+ */
+static void BenchInit(PIDBankType *bank, PIDControllerType *pid,
+                      uint8_t count) {
+  uint8_t ch;
+
+  PIDBank_Init(bank, count);
+  for (ch = 0; ch < count; ch++) {
+    float kp = 0.5f + 0.1f * ch;
+    float ki = (ch % 4 == 3) ? 0.0f : 0.2f + 0.05f * ch; // 含不积分的通道
+    float kd = 0.002f * (ch % 3);
+    float limit = 2.0f + 0.25f * ch;
+
+    PIDBank_SetGains(bank, ch, kp, ki, kd, limit);
+    PID_Init(&pid[ch], kp, ki, kd, limit);
+  }
+}
+
+/**
+ * @brief 一致性与耗时
+ *
+ * @param count 通道数量
+ */
+static void BenchCompare(uint8_t count) {
+  PIDBankType bank;
+  PIDControllerType pid[PID_BANK_MAX];
+  float diff, maxDiff = 0.0f;
+  uint64_t t0, nsBank, nsScalar;
+  uint32_t k;
+  uint8_t ch;
+
+  BenchInit(&bank, pid, count);
+  for (k = 0; k < BENCH_STEPS; k++) {
+    const float *e = benchError[k % BENCH_TABLE];
+
+    PIDBankUpdate(&bank, e, 0.001f);
+    for (ch = 0; ch < count; ch++) {
+      PIDUpdate(&pid[ch], e[ch], 0.001f);
+      diff = fabsf(bank.out[ch] - pid[ch].out) / bank.limit[ch];
+      maxDiff = (diff > maxDiff) ? diff : maxDiff;
+    }
+  }
+
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_ROUNDS * BENCH_TABLE; k++) {
+    PIDBankUpdate(&bank, benchError[k % BENCH_TABLE], 0.001f);
+  }
+  nsBank = SimNowNs() - t0;
+  SIM_KEEP(bank.out[0]);
+
+  t0 = SimNowNs();
+  for (k = 0; k < BENCH_ROUNDS * BENCH_TABLE; k++) {
+    const float *e = benchError[k % BENCH_TABLE];
+
+    for (ch = 0; ch < count; ch++) {
+      PIDUpdate(&pid[ch], e[ch], 0.001f);
+    }
+  }
+  nsScalar = SimNowNs() - t0;
+  SIM_KEEP(pid[0].out);
+
+  printf("N=%-2u  bank %6.1f ns  PIDUpdate x N %6.1f ns  speedup %4.2f  "
+         "max |dout|/limit %.2e\n",
+         count, (double)nsBank / (BENCH_ROUNDS * BENCH_TABLE),
+         (double)nsScalar / (BENCH_ROUNDS * BENCH_TABLE),
+         (double)nsScalar / (double)nsBank, maxDiff);
+  SIM_CHECK(maxDiff < BENCH_OUT_ERROR_MAX, "N=%u max |dout|/limit %.2e", count,
+            maxDiff);
+}
+
+/**
+ * @brief 冻结通道的误差为NaN时，其状态与输出保持不变，其它通道不受影响
+ */
+static void BenchMaskedNaN(void) {
+  const uint8_t frozen = 5;
+  PIDBankType bank;
+  PIDControllerType pid[PID_BANK_MAX];
+  float e[PID_BANK_MAX];
+  float integral, prevError, out;
+  uint32_t k;
+  uint8_t ch, ok = 1;
+
+  BenchInit(&bank, pid, 8);
+  for (k = 0; k < 100; k++) {
+    PIDBankUpdate(&bank, benchError[k], 0.001f);
+  }
+  integral = bank.integral[frozen];
+  prevError = bank.prev_error[frozen];
+  out = bank.out[frozen];
+
+  PIDBank_SetEnableMask(&bank, ~(1u << frozen));
+  for (k = 100; k < 200; k++) {
+    memcpy(e, benchError[k], sizeof(e));
+    e[frozen] = (k & 1u) ? NAN : INFINITY;
+    PIDBankUpdate(&bank, e, 0.001f);
+  }
+
+  // 按位比较，NaN也能发现
+  ok &= (memcmp(&integral, &bank.integral[frozen], sizeof(float)) == 0);
+  ok &= (memcmp(&prevError, &bank.prev_error[frozen], sizeof(float)) == 0);
+  ok &= (memcmp(&out, &bank.out[frozen], sizeof(float)) == 0);
+  printf("masked channel with NaN/Inf input: state %s\n",
+         ok ? "unchanged" : "CHANGED");
+  SIM_CHECK(ok, "frozen channel state changed");
+  for (ch = 0; ch < 8; ch++) {
+    SIM_CHECK(isfinite(bank.out[ch]), "channel %u output %f", ch,
+              bank.out[ch]);
+  }
+
+  // 重新使能后正常工作
+  PIDBank_SetEnableMask(&bank, 0xFFFFFFFFu);
+  PIDBankUpdate(&bank, benchError[200], 0.001f);
+  SIM_CHECK(isfinite(bank.integral[frozen]) && isfinite(bank.out[frozen]),
+            "re-enabled channel not finite");
+}
+
+int main(void) {
+  static const uint8_t counts[] = {4, 8, 16, PID_BANK_MAX};
+  uint8_t k;
+
+  BenchGenerate();
+  for (k = 0; k < sizeof(counts); k++) {
+    BenchCompare(counts[k]);
+  }
+  BenchMaskedNaN();
+
+  return simFailures != 0;
+}
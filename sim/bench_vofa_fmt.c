@@ -0,0 +1,170 @@
+/**
+ * @file bench_vofa_fmt.c
+ * @brief VOFAFloatToStr与snprintf的精度对比与耗时
+ * @note 输出解析回数值后误差超出上限、长度超出VOFA_FLOAT_STR_MAX或
+ *       特殊值格式不对时返回非0
+ */
+#include "sim.h"
+#include "vofa.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_POINTS 200000u
+#define BENCH_ROUNDS 20u
+
+static float benchValue[BENCH_POINTS];     // 全范围
+static float benchTelemetry[BENCH_POINTS]; // 遥测常见量级
+
+/**
+ * @brief 单个值的解析误差上限
+ *
+ * @param value 原值
+ * @param precision 小数位数
+ * @return double 允许误差
+ * @note 定点输出为半个末位加上float的舍入；科学计数法为尾数末位的一半，
+ *       另计逐次除10累积的相对误差
+ */
+static double BenchTolerance(float value, uint8_t precision) {
+  double a = fabs((double)value);
+
+  if (a >= 1e9) {
+    double mantissaUlp = 0.5 * pow(10.0, -precision);
+
+    return a * (mantissaUlp + 4e-6);
+  }
+  return 0.5 * pow(10.0, -precision) + 4.0 * a * FLT_EPSILON;
+}
+
+/**
+ * @brief 全范围随机值与各小数位数，解析回数值比较
+ */
+static void BenchAccuracy(void) {
+  char buf[VOFA_FLOAT_STR_MAX + 1];
+  char ref[64];
+  double err, worst = 0.0;
+  uint32_t k, same = 0, total = 0;
+  uint8_t precision, len, maxLen = 0;
+  float worstValue = 0.0f;
+
+  for (precision = 0; precision <= VOFA_FLOAT_PRECISION_MAX; precision++) {
+    for (k = 0; k < BENCH_POINTS; k++) {
+      float v = benchValue[k];
+
+      len = VOFAFloatToStr(v, precision, buf);
+      buf[len] = '\0';
+      maxLen = (len > maxLen) ? len : maxLen;
+      err = fabs(strtod(buf, NULL) - (double)v) / BenchTolerance(v, precision);
+      if (err > worst) {
+        worst = err;
+        worstValue = v;
+      }
+
+      // 定点范围内与printf逐字比较，仅作统计
+      if (fabsf(v) < 1e9f) {
+        snprintf(ref, sizeof(ref), "%.*f", precision, (double)v);
+        same += (strcmp(buf, ref) == 0);
+        total++;
+      }
+    }
+  }
+
+  len = VOFAFloatToStr(worstValue, VOFA_FLOAT_PRECISION_MAX, buf);
+  buf[len] = '\0';
+  printf("accuracy: worst error %.2f of tolerance (value %.9g -> %s), "
+         "max length %u\n",
+         worst, worstValue, buf, maxLen);
+  printf("          identical to snprintf(\"%%.*f\") in %.2f %% of "
+         "fixed-point cases\n",
+         100.0 * same / total);
+  SIM_CHECK(worst <= 1.0, "error %.2f of tolerance at %.9g", worst,
+            worstValue);
+  SIM_CHECK(maxLen <= VOFA_FLOAT_STR_MAX, "length %u > VOFA_FLOAT_STR_MAX",
+            maxLen);
+}
+
+/**
+ * @brief 特殊值与边界
+ */
+static void BenchSpecial(void) {
+  static const struct {
+    float value;
+    uint8_t precision;
+    const char *text;
+  } cases[] = {
+      {0.0f, 3, "0.000"},          {-1.5f, 1, "-1.5"},
+      {0.9999f, 3, "1.000"},       {-0.0004f, 3, "-0.000"},
+      {123.456f, 0, "123"},        {1e9f, 2, "1.00e9"},
+      {-3.4e38f, 3, "-3.400e38"},  {NAN, 3, "nan"},
+      {INFINITY, 3, "inf"},        {-INFINITY, 3, "-inf"},
+      {4294967040.0f, 1, "4.3e9"}, {1.0f, 9, "1.0000000"},
+  };
+  char buf[VOFA_FLOAT_STR_MAX + 1];
+  uint8_t k, len;
+
+  for (k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+    len = VOFAFloatToStr(cases[k].value, cases[k].precision, buf);
+    buf[len] = '\0';
+    SIM_CHECK(strcmp(buf, cases[k].text) == 0, "%g precision %u: \"%s\", "
+              "expected \"%s\"",
+              cases[k].value, cases[k].precision, buf, cases[k].text);
+  }
+}
+
+/**
+ * @brief 耗时，取遥测常见的量级(±1000)
+ *
+ * @param precision 小数位数
+ */
+static void BenchSpeed(uint8_t precision) {
+  char buf[64];
+  uint64_t t0, nsOwn, nsPrintf;
+  uint32_t r, k, sum = 0;
+
+  t0 = SimNowNs();
+  for (r = 0; r < BENCH_ROUNDS; r++) {
+    for (k = 0; k < BENCH_POINTS; k++) {
+      sum += VOFAFloatToStr(benchTelemetry[k], precision, buf);
+    }
+  }
+  nsOwn = SimNowNs() - t0;
+  SIM_KEEP(sum);
+
+  t0 = SimNowNs();
+  for (r = 0; r < BENCH_ROUNDS; r++) {
+    for (k = 0; k < BENCH_POINTS; k++) {
+      sum += (uint32_t)snprintf(buf, sizeof(buf), "%.*f", precision,
+                                (double)benchTelemetry[k]);
+    }
+  }
+  nsPrintf = SimNowNs() - t0;
+  SIM_KEEP(sum);
+
+  printf("precision %u: VOFAFloatToStr %6.1f ns  snprintf %6.1f ns  "
+         "speedup %4.1f\n",
+         precision, (double)nsOwn / (BENCH_ROUNDS * BENCH_POINTS),
+         (double)nsPrintf / (BENCH_ROUNDS * BENCH_POINTS),
+         (double)nsPrintf / (double)nsOwn);
+}
+
+int main(void) {
+  uint32_t k;
+
+  // 对数均匀分布在[1e-4, 1e12]，随机符号，覆盖定点与科学计数法
+  SimSeed(11);
+  for (k = 0; k < BENCH_POINTS; k++) {
+    float v = powf(10.0f, -4.0f + 16.0f * SimRandu());
+
+    benchValue[k] = (SimRandu() < 0.5f) ? -v : v;
+    benchTelemetry[k] = 2000.0f * SimRandu() - 1000.0f;
+  }
+
+  BenchSpecial();
+  BenchAccuracy();
+  BenchSpeed(2);
+  BenchSpeed(4);
+  BenchSpeed(6);
+
+  return simFailures != 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file check_hc05.c
+ * @brief HC05组帧/解帧与缓冲模式检查，串口函数以内存代替
+ * @note 分别以默认配置(check_hc05)与-DVOFA(check_hc05_vofa，帧尾多4字节)编译，
+ *       支持时以AddressSanitizer运行，组帧越界会直接报错
+ */
+#include "hc05.h"
+#include "ringbuf.h"
+#include "sim.h"
+#include <string.h>
+
+#if defined(VOFA)
+#define CHECK_TAIL_LEN 4
+#else
+#define CHECK_TAIL_LEN 0
+#endif
+
+/*串口发送记录*/
+static uint8_t checkWire[2048];
+static uint32_t checkWireLen;
+static uint32_t checkTxCalls;
+static uint8_t checkTxMaxLen;
+
+static uint8_t CheckTxData(uint8_t *txBuf, uint8_t len) {
+  if (checkWireLen + len <= sizeof(checkWire)) {
+    memcpy(&checkWire[checkWireLen], txBuf, len);
+    checkWireLen += len;
+  }
+  checkTxCalls++;
+  checkTxMaxLen = (len > checkTxMaxLen) ? len : checkTxMaxLen;
+  return 0;
+}
+
+static uint8_t CheckRxData(uint8_t *rxBuf, uint8_t len) {
+  memset(rxBuf, 0x5A, len);
+  return 0;
+}
+
+static void CheckWireReset(void) {
+  checkWireLen = 0;
+  checkTxCalls = 0;
+  checkTxMaxLen = 0;
+}
+
+/**
+ * @brief 发送一包并从线上数据解出，比较载荷
+ *
+ * @param hc05 hc05对象实体
+ * @param len 载荷长度
+ */
+static void CheckRoundTrip(HC05ObjectType *hc05, uint8_t len) {
+  uint8_t payload[255];
+  HC05Packet tx = {0xA5, 0x31, payload, len};
+  HC05Packet rx;
+  uint16_t k;
+
+  for (k = 0; k < len; k++) {
+    payload[k] = (uint8_t)(k * 37 + len);
+  }
+  CheckWireReset();
+  SIM_CHECK(HC05_TxPacket(hc05, &tx) == 0, "len %u: TxPacket failed",
+            (unsigned)len);
+  SIM_CHECK(checkTxCalls == 1, "len %u: %u TxData calls", (unsigned)len,
+            checkTxCalls);
+  SIM_CHECK(checkWireLen ==
+                (uint32_t)(HC05_PACKET_OVERHEAD + len + CHECK_TAIL_LEN),
+            "len %u: frame is %u bytes", (unsigned)len, checkWireLen);
+  SIM_CHECK(HC05_DecodePacket(checkWire, (uint16_t)checkWireLen, &rx) ==
+                HC05_Ok,
+            "len %u: decode failed", (unsigned)len);
+  SIM_CHECK(rx.head == tx.head && rx.id == tx.id && rx.len == len &&
+                memcmp(rx.pData, payload, len) == 0,
+            "len %u: payload mismatch", (unsigned)len);
+#if defined(VOFA)
+  SIM_CHECK(memcmp(&checkWire[checkWireLen - 4], "\x00\x00\x80\x7f", 4) == 0,
+            "len %u: justfloat tail missing", (unsigned)len);
+#endif
+}
+
+/**
+ * @brief 直接发送: 0、中间与最大载荷往返，超长载荷拒绝
+ */
+static void CheckDirect(void) {
+  HC05ObjectType hc05;
+  uint8_t payload[255] = {0};
+  HC05Packet tooLong = {0xA5, 0x01, payload, HC05_PACKET_MAX_PAYLOAD + 1};
+  HC05Packet noData = {0xA5, 0x01, NULL, 3};
+
+  HC05O_bjectInit(&hc05, CheckTxData, CheckRxData);
+  CheckRoundTrip(&hc05, 0);
+  CheckRoundTrip(&hc05, 17);
+  CheckRoundTrip(&hc05, HC05_PACKET_MAX_PAYLOAD);
+  SIM_CHECK(checkWireLen == HC05_FRAME_MAX, "max frame is %u bytes, not %u",
+            checkWireLen, (unsigned)HC05_FRAME_MAX);
+
+  CheckWireReset();
+  SIM_CHECK(HC05_TxPacket(&hc05, &tooLong) == 1, "oversize payload accepted");
+  SIM_CHECK(HC05_TxPacket(&hc05, &noData) == 1, "NULL payload accepted");
+  SIM_CHECK(checkTxCalls == 0, "rejected packet was sent");
+  printf("direct: payload 0/17/%u round trip, max frame %u bytes\n",
+         (unsigned)HC05_PACKET_MAX_PAYLOAD, (unsigned)HC05_FRAME_MAX);
+}
+
+/**
+ * @brief CRC已知值，以及任一位翻转都能检出
+ */
+static void CheckCRC(void) {
+  HC05ObjectType hc05;
+  uint8_t payload[40];
+  HC05Packet tx = {0xA5, 0x07, payload, sizeof(payload)};
+  HC05Packet rx;
+  uint8_t frame[64];
+  uint32_t len, bit, missed = 0;
+
+  SIM_CHECK(HC05_CRC16((const uint8_t *)"123456789", 9) == 0x29B1,
+            "CRC16 check value 0x%04X", HC05_CRC16((const uint8_t *)"123456789", 9));
+
+  memset(payload, 0x3C, sizeof(payload));
+  HC05O_bjectInit(&hc05, CheckTxData, CheckRxData);
+  CheckWireReset();
+  HC05_TxPacket(&hc05, &tx);
+  len = checkWireLen;
+
+  // 包头不参与校验，从id开始逐位翻转
+  for (bit = 8; bit < (len - CHECK_TAIL_LEN) * 8; bit++) {
+    memcpy(frame, checkWire, len);
+    frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    if (HC05_DecodePacket(frame, (uint16_t)len, &rx) == HC05_Ok) {
+      missed++;
+    }
+  }
+  printf("crc: %u single-bit errors undetected\n", missed);
+  SIM_CHECK(missed == 0, "%u bit flips not detected", missed);
+}
+
+/**
+ * @brief 缓冲模式: 整包写入、空间不足整包丢弃、TxPump按段发出，接收缓冲取数
+ */
+static void CheckBuffered(void) {
+  static uint8_t txStorage[512], rxStorage[64];
+  RingBufType txRing, rxRing;
+  HC05ObjectType hc05;
+  uint8_t payload[255];
+  HC05Packet tx = {0xA5, 0x02, payload, HC05_PACKET_MAX_PAYLOAD};
+  HC05Packet rx;
+  uint8_t bytes[8] = {1, 2, 3, 4, 5, 6, 7, 8}, got[8];
+
+  memset(payload, 0xC3, sizeof(payload));
+  RingBuf_Init(&txRing, txStorage, sizeof(txStorage));
+  RingBuf_Init(&rxRing, rxStorage, sizeof(rxStorage));
+  HC05O_bjectInit(&hc05, CheckTxData, CheckRxData);
+  HC05_SetBuffers(&hc05, &txRing, &rxRing);
+
+  CheckWireReset();
+  SIM_CHECK(HC05_TxPacket(&hc05, &tx) == 0, "first packet rejected");
+  SIM_CHECK(HC05_TxPacket(&hc05, &tx) == 0, "second packet rejected");
+  SIM_CHECK(HC05_TxPacket(&hc05, &tx) == 1, "third packet fit in 512 bytes");
+  SIM_CHECK(RingBufUsed(&txRing) == 2u * HC05_FRAME_MAX, "%u bytes buffered",
+            RingBufUsed(&txRing));
+  SIM_CHECK(checkTxCalls == 0, "buffered packet sent directly");
+
+  HC05_TxPump(&hc05);
+  SIM_CHECK(RingBufUsed(&txRing) == 0, "pump left %u bytes",
+            RingBufUsed(&txRing));
+  SIM_CHECK(checkWireLen == 2u * HC05_FRAME_MAX, "pumped %u bytes",
+            checkWireLen);
+  SIM_CHECK(HC05_DecodePacket(checkWire, HC05_FRAME_MAX, &rx) == HC05_Ok &&
+                HC05_DecodePacket(&checkWire[HC05_FRAME_MAX], HC05_FRAME_MAX,
+                                  &rx) == HC05_Ok,
+            "pumped frames do not decode");
+
+  SIM_CHECK(HC05_RxFeed(&hc05, bytes, sizeof(bytes)) == sizeof(bytes),
+            "rx feed short");
+  SIM_CHECK(HC05_RxPacket(&hc05, got, 9) == 1, "short rx buffer returned data");
+  SIM_CHECK(HC05_RxPacket(&hc05, got, 8) == 0 &&
+                memcmp(got, bytes, sizeof(bytes)) == 0,
+            "rx data mismatch");
+  printf("buffered: 2 max frames queued, third dropped, pumped in %u calls "
+         "(largest %u bytes)\n",
+         checkTxCalls, (unsigned)checkTxMaxLen);
+}
+
+int main(void) {
+  printf("hc05 %s: overhead %u, tail %u, max payload %u\n",
+#if defined(VOFA)
+         "VOFA",
+#else
+         "default",
+#endif
+         (unsigned)HC05_PACKET_OVERHEAD, (unsigned)CHECK_TAIL_LEN,
+         (unsigned)HC05_PACKET_MAX_PAYLOAD);
+  CheckDirect();
+  CheckCRC();
+  CheckBuffered();
+
+  return simFailures != 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file check_mahony_euler.c
+ * @brief 四元数到FRD/NED欧拉角的转换: 航向全范围(含负航向)扫描、角度不取整、
+ *        航向0/360边界
+ * @note 角度误差超出上限、航向越出[0, 360)或NED与FRD映射不符时返回非0
+ */
+#include "mahony.h"
+#include "sim.h"
+#include <math.h>
+
+/*float计算的角度误差上限(deg)*/
+#define CHECK_ANGLE_TOL 1e-3f
+
+/**
+ * @brief 由ZYX欧拉角(deg)构造四元数
+ */
+static void CheckQuat(float roll, float pitch, float yaw, float q[4]) {
+  float cr = cosf(roll * 0.00872665f), sr = sinf(roll * 0.00872665f);
+  float cp = cosf(pitch * 0.00872665f), sp = sinf(pitch * 0.00872665f);
+  float cy = cosf(yaw * 0.00872665f), sy = sinf(yaw * 0.00872665f);
+
+  q[0] = cr * cp * cy + sr * sp * sy;
+  q[1] = sr * cp * cy - cr * sp * sy;
+  q[2] = cr * sp * cy + sr * cp * sy;
+  q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+/*两个航向角(deg)的环绕差*/
+static float CheckYawDiff(float a, float b) {
+  float d = fmodf(a - b + 540.0f, 360.0f) - 180.0f;
+
+  return fabsf(d);
+}
+
+/**
+ * @brief 航向-180°~180°扫描: FRD航向归到[0, 360)，NED为(360 - FRD) mod 360
+ */
+static void CheckYawSweep(void) {
+  MahonyFilterType ahrs;
+  const FRDEulerAngle *frd;
+  const NEDEulerAngle *ned;
+  float yaw, worst = 0.0f, expectNed;
+  uint32_t n = 0;
+
+  MahonyFilterCoreInit(&ahrs);
+  for (yaw = -180.0f; yaw <= 180.0f; yaw += 0.25f) {
+    CheckQuat(12.5f, -7.25f, yaw, ahrs.filter.q);
+    ahrs.cacheValid = 0;
+    frd = MahonyGetFRD(&ahrs);
+    ned = MahonyGetNED(&ahrs);
+    expectNed = fmodf(360.0f - yaw, 360.0f);
+
+    SIM_CHECK(frd->yaw >= 0.0f && frd->yaw < 360.0f, "yaw %.2f: frd %.4f",
+              yaw, frd->yaw);
+    SIM_CHECK(ned->yaw >= 0.0f && ned->yaw < 360.0f, "yaw %.2f: ned %.4f",
+              yaw, ned->yaw);
+    worst = fmaxf(worst, CheckYawDiff(frd->yaw, yaw));
+    worst = fmaxf(worst, CheckYawDiff(ned->yaw, expectNed));
+    worst = fmaxf(worst, fabsf(frd->roll - 12.5f));
+    worst = fmaxf(worst, fabsf(frd->pitch + 7.25f));
+    worst = fmaxf(worst, fabsf(ned->pitch - 7.25f));
+    n++;
+  }
+  printf("yaw sweep: %u orientations, worst angle error %.5f deg\n", n,
+         worst);
+  SIM_CHECK(worst < CHECK_ANGLE_TOL, "angle error %.5f deg", worst);
+}
+
+/**
+ * @brief 负航向、小数角度与0/360边界的具体值
+ */
+static void CheckCases(void) {
+  static const struct {
+    float yaw;     // 输入航向(deg)
+    float frdYaw;  // 期望FRD航向
+    float nedYaw;  // 期望NED航向
+  } cases[] = {
+      {-30.0f, 330.0f, 30.0f}, {-90.5f, 269.5f, 90.5f},
+      {30.0f, 30.0f, 330.0f},  {0.0f, 0.0f, 0.0f},
+      {-1e-5f, 0.0f, 0.0f},    {179.75f, 179.75f, 180.25f},
+  };
+  MahonyFilterType ahrs;
+  const FRDEulerAngle *frd;
+  const NEDEulerAngle *ned;
+  uint8_t k;
+
+  MahonyFilterCoreInit(&ahrs);
+  for (k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+    CheckQuat(0.5f, 0.0f, cases[k].yaw, ahrs.filter.q);
+    ahrs.cacheValid = 0;
+    frd = MahonyGetFRD(&ahrs);
+    ned = MahonyGetNED(&ahrs);
+    SIM_CHECK(CheckYawDiff(frd->yaw, cases[k].frdYaw) < CHECK_ANGLE_TOL &&
+                  frd->yaw < 360.0f,
+              "yaw %g: frd %.4f, expected %g", cases[k].yaw, frd->yaw,
+              cases[k].frdYaw);
+    SIM_CHECK(CheckYawDiff(ned->yaw, cases[k].nedYaw) < CHECK_ANGLE_TOL &&
+                  ned->yaw < 360.0f,
+              "yaw %g: ned %.4f, expected %g", cases[k].yaw, ned->yaw,
+              cases[k].nedYaw);
+    // 角度不取整
+    SIM_CHECK(fabsf(frd->roll - 0.5f) < CHECK_ANGLE_TOL, "roll %.4f", frd->roll);
+  }
+}
+
+int main(void) {
+  CheckYawSweep();
+  CheckCases();
+
+  return simFailures != 0;
+}
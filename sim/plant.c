@@ -0,0 +1,231 @@
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+
+/*直流电机电气时间常数通常远小于控制周期，按该步长细分积分*/
+#define PLANT_DC_SUBSTEP 1e-5f
+
+/**
+ * @brief 初始化直流电机，初始静止、无负载
+ *
+ * @param motor 直流电机
+ * @param J 转动惯量(kg·m²)
+ * @param b 粘滞摩擦系数(N·m·s/rad)
+ * @param K 转矩常数与反电动势常数(N·m/A)
+ * @param R 电枢电阻(Ω)
+ * @param L 电枢电感(H)
+ */
+void PlantDCMotor_Init(PlantDCMotorType *motor, float J, float b, float K,
+                       float R, float L) {
+  motor->J = J;
+  motor->b = b;
+  motor->K = K;
+  motor->R = R;
+  motor->L = L;
+  motor->load = 0.0f;
+  motor->current = 0.0f;
+  motor->speed = 0.0f;
+  motor->angle = 0.0f;
+}
+
+/**
+ * @brief 电压保持dt不变，推进直流电机状态
+ *
+ * @param motor 直流电机
+ * @param voltage 电枢电压(V)
+ * @param dt 时间(s)
+ * @return float 转速(rad/s)
+ * @note L*di/dt = V - R*i - K*w，J*dw/dt = K*i - b*w - load，
+ *       按PLANT_DC_SUBSTEP细分的半隐式欧拉积分
+ */
+float PlantDCMotorStep(PlantDCMotorType *motor, float voltage, float dt) {
+  uint32_t steps = (uint32_t)ceilf(dt / PLANT_DC_SUBSTEP);
+  float h = dt / (float)steps;
+  uint32_t k;
+
+  for (k = 0; k < steps; k++) {
+    motor->current +=
+        h * (voltage - motor->R * motor->current - motor->K * motor->speed) /
+        motor->L;
+    motor->speed += h *
+                    (motor->K * motor->current - motor->b * motor->speed -
+                     motor->load) /
+                    motor->J;
+    motor->angle += h * motor->speed;
+  }
+  return motor->speed;
+}
+
+/**
+ * @brief 初始化一阶惯性加纯滞后对象，输出与延迟线清零
+ *
+ * @param plant FOPDT对象
+ * @param gain 静态增益
+ * @param tau 时间常数(s)
+ * @param deadTime 纯滞后(s)，超出PLANT_FOPDT_DELAY_MAX个采样时截断
+ * @param dt 仿真步长(s)，PlantFOPDTStep需以相同步长调用
+ */
+void PlantFOPDT_Init(PlantFOPDTType *plant, float gain, float tau,
+                     float deadTime, float dt) {
+  uint32_t len = (uint32_t)lroundf(deadTime / dt);
+  uint32_t k;
+
+  if (len > PLANT_FOPDT_DELAY_MAX) {
+    len = PLANT_FOPDT_DELAY_MAX;
+  }
+  plant->gain = gain;
+  plant->tau = tau;
+  plant->deadTime = (float)len * dt;
+  plant->y = 0.0f;
+  plant->delayLen = (uint16_t)len;
+  plant->delayHead = 0;
+  for (k = 0; k < PLANT_FOPDT_DELAY_MAX; k++) {
+    plant->delay[k] = 0.0f;
+  }
+}
+
+/**
+ * @brief 推进一个步长
+ *
+ * @param plant FOPDT对象
+ * @param u 输入，在dt内保持不变
+ * @param dt 仿真步长(s)
+ * @return float 输出
+ * @note 零阶保持下的精确离散化 y += (1 - e^(-dt/tau)) * (gain*u(t-θ) - y)
+ */
+float PlantFOPDTStep(PlantFOPDTType *plant, float u, float dt) {
+  float delayed = u;
+
+  if (plant->delayLen > 0) {
+    delayed = plant->delay[plant->delayHead];
+    plant->delay[plant->delayHead] = u;
+    if (++plant->delayHead >= plant->delayLen) {
+      plant->delayHead = 0;
+    }
+  }
+
+  plant->y += (1.0f - expf(-dt / plant->tau)) * (plant->gain * delayed -
+                                                 plant->y);
+  return plant->y;
+}
+
+/**
+ * @brief 初始化刚体，水平静止，默认噪声接近MPU6050+IST8310
+ *
+ * @param body 刚体
+ */
+void PlantRigidBody_Init(PlantRigidBodyType *body) {
+  body->q[0] = 1.0f;
+  body->q[1] = 0.0f;
+  body->q[2] = 0.0f;
+  body->q[3] = 0.0f;
+  body->gyroBias[0] = 0.0f;
+  body->gyroBias[1] = 0.0f;
+  body->gyroBias[2] = 0.0f;
+  body->gyroNoise = 0.003f;
+  body->accelNoise = 0.02f;
+  body->magNoise = 0.3f;
+  body->gravity = 9.8f;
+  body->linAccel[0] = 0.0f;
+  body->linAccel[1] = 0.0f;
+  body->linAccel[2] = 0.0f;
+  // 中纬度北半球: 水平分量指北，竖直分量向下
+  body->field[0] = 25.0f;
+  body->field[1] = 0.0f;
+  body->field[2] = -40.0f;
+}
+
+/**
+ * @brief 角速度在dt内保持不变，推进真实姿态
+ *
+ * @param body 刚体
+ * @param w 载体系角速度(rad/s)
+ * @param dt 时间(s)
+ */
+void PlantRigidBodyStep(PlantRigidBodyType *body, const float w[3],
+                        float dt) {
+  PlantQuatIntegrate(body->q, w, dt);
+}
+
+/**
+ * @brief 按当前真实姿态合成一次IMU测量
+ *
+ * @param body 刚体
+ * @param w 载体系真实角速度(rad/s)
+ * @param imu 输出，陀螺仪rad/s(含零偏与噪声)，加速度m/s²，磁场uT
+ * @note MahonyUpdateAHRS等接口要求陀螺仪°/s，调用前需自行换算
+ */
+void PlantRigidBodyIMU(const PlantRigidBodyType *body, const float w[3],
+                       MahonyInput *imu) {
+  const float *q = body->q;
+  float r[3][3];
+  float f[3];
+  uint8_t i;
+
+  // 旋转矩阵(载体系->导航系)，导航系向量转到载体系用其转置
+  r[0][0] = 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]);
+  r[0][1] = 2.0f * (q[1] * q[2] - q[0] * q[3]);
+  r[0][2] = 2.0f * (q[1] * q[3] + q[0] * q[2]);
+  r[1][0] = 2.0f * (q[1] * q[2] + q[0] * q[3]);
+  r[1][1] = 1.0f - 2.0f * (q[1] * q[1] + q[3] * q[3]);
+  r[1][2] = 2.0f * (q[2] * q[3] - q[0] * q[1]);
+  r[2][0] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+  r[2][1] = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+  r[2][2] = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+
+  imu->gyro.x = w[0] + body->gyroBias[0] + body->gyroNoise * SimRandn();
+  imu->gyro.y = w[1] + body->gyroBias[1] + body->gyroNoise * SimRandn();
+  imu->gyro.z = w[2] + body->gyroBias[2] + body->gyroNoise * SimRandn();
+
+  // 加速度计测得比力: 线加速度减去重力加速度，静止时为导航系+Z
+  for (i = 0; i < 3; i++) {
+    f[i] = r[0][i] * body->linAccel[0] + r[1][i] * body->linAccel[1] +
+           r[2][i] * (body->linAccel[2] + body->gravity);
+  }
+  imu->accel.x = f[0] + body->accelNoise * SimRandn();
+  imu->accel.y = f[1] + body->accelNoise * SimRandn();
+  imu->accel.z = f[2] + body->accelNoise * SimRandn();
+
+  for (i = 0; i < 3; i++) {
+    f[i] = r[0][i] * body->field[0] + r[1][i] * body->field[1] +
+           r[2][i] * body->field[2];
+  }
+  imu->mag.x = f[0] + body->magNoise * SimRandn();
+  imu->mag.y = f[1] + body->magNoise * SimRandn();
+  imu->mag.z = f[2] + body->magNoise * SimRandn();
+  imu->timestamp = 0;
+}
+
+/**
+ * @brief 四元数按恒定角速度精确积分，q = q * exp([0, w*dt/2])
+ *
+ * @param q 单位四元数[q0, q1, q2, q3]，原地更新
+ * @param w 载体系角速度(rad/s)
+ * @param dt 时间(s)
+ * @note 以双精度计算，作为各滤波器积分误差的参考
+ */
+void PlantQuatIntegrate(float q[4], const float w[3], float dt) {
+  double hx = 0.5 * (double)w[0] * dt;
+  double hy = 0.5 * (double)w[1] * dt;
+  double hz = 0.5 * (double)w[2] * dt;
+  double theta = sqrt(hx * hx + hy * hy + hz * hz);
+  double d0 = cos(theta);
+  double k = (theta > 1e-12) ? sin(theta) / theta : 1.0;
+  double a = q[0], b = q[1], c = q[2], d = q[3];
+  double n;
+
+  hx *= k;
+  hy *= k;
+  hz *= k;
+  q[0] = (float)(a * d0 - b * hx - c * hy - d * hz);
+  q[1] = (float)(b * d0 + a * hx + c * hz - d * hy);
+  q[2] = (float)(c * d0 + a * hy - b * hz + d * hx);
+  q[3] = (float)(d * d0 + a * hz + b * hy - c * hx);
+
+  n = 1.0 / sqrt((double)q[0] * q[0] + (double)q[1] * q[1] +
+                 (double)q[2] * q[2] + (double)q[3] * q[3]);
+  q[0] = (float)(q[0] * n);
+  q[1] = (float)(q[1] * n);
+  q[2] = (float)(q[2] * n);
+  q[3] = (float)(q[3] * n);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file plant.h
+ * @brief 主机仿真用被控对象模型: 直流电机、一阶惯性加纯滞后与刚体转动
+ * @note 仅在MYDRIVER_HOST_BUILD下编译，不参与目标板构建
+ */
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <stdint.h>
+
+#include "mahony.h"
+
+/*纯滞后缓冲长度上限(采样数)*/
+#ifndef PLANT_FOPDT_DELAY_MAX
+#define PLANT_FOPDT_DELAY_MAX 4096
+#endif
+
+/*直流电机，输入电枢电压，输出转速*/
+typedef struct {
+  float J;       // 转动惯量(kg·m²)
+  float b;       // 粘滞摩擦系数(N·m·s/rad)
+  float K;       // 转矩常数与反电动势常数(N·m/A)
+  float R;       // 电枢电阻(Ω)
+  float L;       // 电枢电感(H)
+  float load;    // 负载转矩(N·m)
+  float current; // 电枢电流(A)
+  float speed;   // 转速(rad/s)
+  float angle;   // 转角(rad)
+} PlantDCMotorType;
+
+/*一阶惯性加纯滞后(FOPDT): G(s) = gain * e^(-deadTime*s) / (tau*s + 1)*/
+typedef struct {
+  float gain;     // 静态增益
+  float tau;      // 时间常数(s)
+  float deadTime; // 纯滞后(s)，按采样周期取整
+  float y;        // 输出
+  float delay[PLANT_FOPDT_DELAY_MAX]; // 输入延迟线
+  uint16_t delayLen;                  // 延迟采样数
+  uint16_t delayHead;                 // 延迟线写位置
+} PlantFOPDTType;
+
+/*刚体转动，按给定角速度精确积分真实姿态并合成IMU测量*/
+typedef struct {
+  float q[4];        // 真实姿态(载体系->导航系，导航系Z轴朝上)
+  float gyroBias[3]; // 陀螺仪零偏(rad/s)
+  float gyroNoise;   // 陀螺仪噪声标准差(rad/s)
+  float accelNoise;  // 加速度计噪声标准差(m/s²)
+  float magNoise;    // 磁力计噪声标准差(uT)
+  float gravity;     // 重力加速度(m/s²)
+  float linAccel[3]; // 导航系线加速度(m/s²)，加速度计同时测得
+  float field[3];    // 导航系地磁场(uT)，北向分量在x轴
+} PlantRigidBodyType;
+
+void PlantDCMotor_Init(PlantDCMotorType *motor, float J, float b, float K,
+                       float R, float L);
+float PlantDCMotorStep(PlantDCMotorType *motor, float voltage, float dt);
+
+void PlantFOPDT_Init(PlantFOPDTType *plant, float gain, float tau,
+                     float deadTime, float dt);
+float PlantFOPDTStep(PlantFOPDTType *plant, float u, float dt);
+
+void PlantRigidBody_Init(PlantRigidBodyType *body);
+void PlantRigidBodyStep(PlantRigidBodyType *body, const float w[3], float dt);
+void PlantRigidBodyIMU(const PlantRigidBodyType *body, const float w[3],
+                       MahonyInput *imu);
+void PlantQuatIntegrate(float q[4], const float w[3], float dt);
+
+#endif // !PLANT_H
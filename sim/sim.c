@@ -0,0 +1,149 @@
+#define _POSIX_C_SOURCE 200809L
+#include "sim.h"
+#include <math.h>
+#include <time.h>
+
+int simFailures = 0;
+
+static uint32_t simRandState = 0x12345678u; // xorshift32状态
+
+/**
+ * @brief 单调时钟
+ *
+ * @return uint64_t 纳秒
+ */
+uint64_t SimNowNs(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 设置随机数种子，相同种子得到相同序列，便于复现
+ *
+ * @param seed 种子，0按1处理
+ */
+void SimSeed(uint32_t seed) { simRandState = (seed == 0) ? 1u : seed; }
+
+/**
+ * @brief 均匀分布随机数
+ *
+ * @return float [0, 1)
+ */
+float SimRandu(void) {
+  uint32_t x = simRandState;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  simRandState = x;
+  return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief 标准正态分布随机数(Box-Muller)
+ *
+ * @return float 均值0，标准差1
+ */
+float SimRandn(void) {
+  float u1 = SimRandu();
+  float u2 = SimRandu();
+
+  if (u1 < 1e-7f) {
+    u1 = 1e-7f;
+  }
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+/**
+ * @brief 由响应序列计算阶跃响应指标
+ *
+ * @param y 响应序列，y[k]为第k+1个周期结束时的输出
+ * @param n 序列长度
+ * @param dt 采样周期(s)
+ * @param y0 阶跃前的输出
+ * @param target 阶跃目标值
+ * @param info 输出指标，百分比均相对阶跃幅值|target - y0|
+ */
+void SimStepMetrics(const float *y, uint32_t n, float dt, float y0,
+                    float target, SimStepInfo *info) {
+  float span = target - y0;
+  float sign = (span >= 0.0f) ? 1.0f : -1.0f;
+  float peak = 0.0f;
+  int32_t k10 = -1, k90 = -1, kLast = -1;
+  uint32_t k;
+
+  span = fabsf(span);
+  for (k = 0; k < n; k++) {
+    // 归一化到0~1，正向阶跃与反向阶跃统一处理
+    float r = sign * (y[k] - y0) / span;
+
+    if ((k10 < 0) && (r >= 0.1f))
+      k10 = (int32_t)k;
+    if ((k90 < 0) && (r >= 0.9f))
+      k90 = (int32_t)k;
+    if (r > peak)
+      peak = r;
+    if (fabsf(r - 1.0f) > 0.02f)
+      kLast = (int32_t)k;
+  }
+
+  info->riseTime = (k90 >= 0) ? (float)(k90 - k10) * dt : -1.0f;
+  info->overshoot = (peak > 1.0f) ? (peak - 1.0f) * 100.0f : 0.0f;
+  info->settlingTime = (float)(kLast + 1) * dt;
+  info->steadyError = fabsf(y[n - 1] - target) / span * 100.0f;
+}
+
+/**
+ * @brief 打印阶跃响应指标
+ *
+ * @param name 名称
+ * @param info 阶跃响应指标
+ */
+void SimPrintStep(const char *name, const SimStepInfo *info) {
+  printf("%-28s rise %7.4f s  overshoot %6.2f %%  settle %7.4f s  "
+         "ess %6.3f %%\n",
+         name, info->riseTime, info->overshoot, info->settlingTime,
+         info->steadyError);
+}
+
+/**
+ * @brief 两个姿态四元数之间的旋转角
+ *
+ * @param qa 单位四元数[q0, q1, q2, q3]
+ * @param qb 单位四元数[q0, q1, q2, q3]
+ * @return float 夹角(rad)，0~pi
+ */
+float SimQuatAngle(const float qa[4], const float qb[4]) {
+  // 相对旋转 r = qa^-1 * qb，用atan2避免小角度时acosf精度不足
+  float r0 = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+  float r1 = qa[0] * qb[1] - qa[1] * qb[0] - qa[2] * qb[3] + qa[3] * qb[2];
+  float r2 = qa[0] * qb[2] + qa[1] * qb[3] - qa[2] * qb[0] - qa[3] * qb[1];
+  float r3 = qa[0] * qb[3] - qa[1] * qb[2] + qa[2] * qb[1] - qa[3] * qb[0];
+
+  return 2.0f * atan2f(sqrtf(r1 * r1 + r2 * r2 + r3 * r3), fabsf(r0));
+}
+
+/**
+ * @brief 两个姿态的倾斜角之差，忽略航向
+ *
+ * @param qa 单位四元数[q0, q1, q2, q3]
+ * @param qb 单位四元数[q0, q1, q2, q3]
+ * @return float 两姿态下载体系重力方向的夹角(rad)
+ */
+float SimTiltAngle(const float qa[4], const float qb[4]) {
+  // 导航系Z轴在载体系中的方向，即旋转矩阵第三行
+  float ax = 2.0f * (qa[1] * qa[3] - qa[0] * qa[2]);
+  float ay = 2.0f * (qa[2] * qa[3] + qa[0] * qa[1]);
+  float az = 1.0f - 2.0f * (qa[1] * qa[1] + qa[2] * qa[2]);
+  float bx = 2.0f * (qb[1] * qb[3] - qb[0] * qb[2]);
+  float by = 2.0f * (qb[2] * qb[3] + qb[0] * qb[1]);
+  float bz = 1.0f - 2.0f * (qb[1] * qb[1] + qb[2] * qb[2]);
+  float cx = ay * bz - az * by;
+  float cy = az * bx - ax * bz;
+  float cz = ax * by - ay * bx;
+
+  return atan2f(sqrtf(cx * cx + cy * cy + cz * cz),
+                ax * bx + ay * by + az * bz);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file sim.h
+ * @brief 主机仿真与性能测试公用工具: 计时、随机数、阶跃响应指标与检查计数
+ * @note 仅在MYDRIVER_HOST_BUILD下编译，不参与目标板构建
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*检查失败次数，各程序以其作为main的返回值供ctest判定*/
+extern int simFailures;
+
+/*检查条件，失败时打印位置与说明并计数，不中断运行*/
+#define SIM_CHECK(cond, ...)                                                   \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      simFailures++;                                                           \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);                              \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+/*周期计数，x86上为时间戳计数器(TSC，按标称频率计数)，其余平台不可用*/
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SIM_HAVE_CYCLES 1
+static inline uint64_t SimCycles(void) { return __rdtsc(); }
+#else
+#define SIM_HAVE_CYCLES 0
+static inline uint64_t SimCycles(void) { return 0; }
+#endif
+
+/*阻止编译器把被测结果优化掉*/
+#define SIM_KEEP(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+/*阶跃响应指标*/
+typedef struct {
+  float riseTime;     // 10%~90%上升时间(s)，未到达90%为-1
+  float overshoot;    // 超调量(%阶跃幅值)
+  float settlingTime; // 最后一次离开±2%误差带的时间(s)
+  float steadyError;  // 末值误差(%阶跃幅值)
+} SimStepInfo;
+
+uint64_t SimNowNs(void);
+void SimSeed(uint32_t seed);
+float SimRandu(void);
+float SimRandn(void);
+void SimStepMetrics(const float *y, uint32_t n, float dt, float y0,
+                    float target, SimStepInfo *info);
+void SimPrintStep(const char *name, const SimStepInfo *info);
+float SimQuatAngle(const float qa[4], const float qb[4]);
+float SimTiltAngle(const float qa[4], const float qb[4]);
+
+#endif // !SIM_H
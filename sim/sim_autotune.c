@@ -0,0 +1,224 @@
+/**
+ * @file sim_autotune.c
+ * @brief 继电反馈自整定对FOPDT对象: 临界增益/周期与解析值比较，整定后闭环阶跃响应
+ * @note Ku/Tu偏离解析值过多、整定失败或闭环不收敛时返回非0
+ */
+#include "pid.h"
+#include "pid_autotune.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_DT 0.001f
+/*闭环阶跃响应时长(s)*/
+#define SIM_STEP_TIME 60.0f
+#define SIM_STEP_MAX 60000u
+/*继电实验: 幅值、回差与测量噪声*/
+#define SIM_RELAY_AMP 1.0f
+#define SIM_RELAY_HYST 0.02f
+#define SIM_NOISE 0.002f
+/*Ku允许范围(相对解析值)：继电法按正弦基波估计，惯性为主时输出接近三角波，
+  基波幅值约为峰值的8/pi^2，Ku偏低可达约20%*/
+#define SIM_KU_RATIO_MIN 0.75f
+#define SIM_KU_RATIO_MAX 1.05f
+/*Tu与解析值的相对偏差上限*/
+#define SIM_TU_ERROR_MAX 0.10f
+
+/*被控对象*/
+typedef struct {
+  const char *name;
+  float gain, tau, deadTime;
+} SimPlant;
+
+/*整定规则与闭环超调上限(%)，no-overshoot在惯性为主的对象上仍有超调*/
+typedef struct {
+  const char *name;
+  PIDTuneRuleType rule;
+  float overshootMax;
+} SimRule;
+
+static const SimPlant simPlants[] = {
+    {"fopdt K=2 tau=2 theta=0.3", 2.0f, 2.0f, 0.3f},
+    {"fopdt K=1 tau=0.5 theta=0.2", 1.0f, 0.5f, 0.2f},
+    {"fopdt K=0.5 tau=1 theta=1", 0.5f, 1.0f, 1.0f},
+};
+
+static const SimRule simRules[] = {
+    {"ziegler-nichols", PID_TUNE_ZieglerNichols, 80.0f},
+    {"tyreus-luyben", PID_TUNE_TyreusLuyben, 40.0f},
+    {"no-overshoot", PID_TUNE_NoOvershoot, 45.0f},
+};
+
+static float simTrace[SIM_STEP_MAX];
+
+/**
+ * @brief FOPDT临界点: 相位 -atan(w*tau) - w*theta = -pi 处的增益与周期
+ *
+ * @param p 被控对象
+ * @param ku 输出，临界增益
+ * @param tu 输出，临界周期(s)
+ */
+static void SimUltimate(const SimPlant *p, float *ku, float *tu) {
+  double lo = 1e-6, hi = 3.14159265 / p->deadTime, w = 0.0;
+  uint8_t k;
+
+  // 相位随w单调下降，二分求解
+  for (k = 0; k < 60; k++) {
+    w = 0.5 * (lo + hi);
+    if (atan(w * p->tau) + w * p->deadTime < 3.14159265) {
+      lo = w;
+    } else {
+      hi = w;
+    }
+  }
+  *ku = (float)(sqrt(1.0 + w * p->tau * w * p->tau) / p->gain);
+  *tu = (float)(6.28318531 / w);
+}
+
+/**
+ * @brief 继电实验，结果在tune中
+ *
+ * @param p 被控对象
+ * @param tune 自整定
+ * @return float 实验用时(s)
+ */
+static float SimRelay(const SimPlant *p, PIDAutoTuneType *tune) {
+  PlantFOPDTType plant;
+  float y = 0.0f;
+
+  PlantFOPDT_Init(&plant, p->gain, p->tau, p->deadTime, SIM_DT);
+  PIDAutoTune_Init(tune, 0.0f, 0.0f, SIM_RELAY_AMP, SIM_RELAY_HYST, 4,
+                   300.0f);
+  while (PIDAutoTuneUpdate(tune, y + SIM_NOISE * SimRandn(), SIM_DT) ==
+         PID_TUNE_Running) {
+    y = PlantFOPDTStep(&plant, tune->out, SIM_DT);
+  }
+  return tune->elapsed;
+}
+
+/**
+ * @brief 按整定结果闭环，单位阶跃
+ *
+ * @param p 被控对象
+ * @param tune 已完成的自整定
+ * @param r 整定规则
+ */
+static void SimStep(const SimPlant *p, const PIDAutoTuneType *tune,
+                    const SimRule *r) {
+  PlantFOPDTType plant;
+  PIDControllerType pid;
+  SimStepInfo info;
+  const uint32_t n = (uint32_t)(SIM_STEP_TIME / SIM_DT);
+  uint32_t k;
+
+  PlantFOPDT_Init(&plant, p->gain, p->tau, p->deadTime, SIM_DT);
+  PID_Init(&pid, 0.0f, 0.0f, 0.0f, 10.0f);
+  SIM_CHECK(PIDAutoTune_Apply(tune, r->rule, &pid) == PID_TUNE_Done,
+            "%s apply refused", r->name);
+  for (k = 0; k < n; k++) {
+    PIDUpdate(&pid, 1.0f - plant.y, SIM_DT);
+    simTrace[k] = PlantFOPDTStep(&plant, pid.out, SIM_DT);
+  }
+
+  SimStepMetrics(simTrace, n, SIM_DT, 0.0f, 1.0f, &info);
+  SimPrintStep(r->name, &info);
+  printf("  kp %.3f ki %.3f kd %.3f\n", pid.core.kp, pid.core.ki,
+         pid.core.kd);
+  SIM_CHECK(info.overshoot < r->overshootMax, "%s overshoot %.1f %%", r->name,
+            info.overshoot);
+  SIM_CHECK(info.settlingTime < 0.8f * SIM_STEP_TIME, "%s settling %.2f s",
+            r->name, info.settlingTime);
+  SIM_CHECK(info.steadyError < 1.0f, "%s steady error %.3f %%", r->name,
+            info.steadyError);
+}
+
+/**
+ * @brief 未完成(进行中、超时失败)的整定不得修改运行中的pid环；
+ *        完成后写入时清零积分、微分与输出历史
+ */
+static void SimApplyGuard(void) {
+  const SimPlant *p = &simPlants[0];
+  PIDAutoTuneType tune;
+  PIDControllerType pid, before;
+  PlantFOPDTType plant;
+  PIDAutoTuneState state;
+  uint32_t k;
+
+  PID_Init(&pid, 1.5f, 0.8f, 0.1f, 10.0f);
+  PID_SetSlewRate(&pid, 50.0f);
+  for (k = 0; k < 100; k++) {
+    PIDUpdateSP(&pid, 1.0f, 0.01f * (float)k, SIM_DT);
+  }
+  before = pid;
+
+  // 刚初始化，仍在进行中
+  PIDAutoTune_Init(&tune, 0.0f, 0.0f, SIM_RELAY_AMP, SIM_RELAY_HYST, 4,
+                   300.0f);
+  state = PIDAutoTune_Apply(&tune, PID_TUNE_ZieglerNichols, &pid);
+  SIM_CHECK(state == PID_TUNE_Running, "running tune returned %d", state);
+  SIM_CHECK(memcmp(&pid, &before, sizeof(pid)) == 0,
+            "running tune modified the pid");
+
+  // 超时过短，实验失败
+  PlantFOPDT_Init(&plant, p->gain, p->tau, p->deadTime, SIM_DT);
+  PIDAutoTune_Init(&tune, 0.0f, 0.0f, SIM_RELAY_AMP, SIM_RELAY_HYST, 4, 0.5f);
+  while (PIDAutoTuneUpdate(&tune, plant.y, SIM_DT) == PID_TUNE_Running) {
+    PlantFOPDTStep(&plant, tune.out, SIM_DT);
+  }
+  state = PIDAutoTune_Apply(&tune, PID_TUNE_ZieglerNichols, &pid);
+  SIM_CHECK(state == PID_TUNE_Failed, "timed out tune returned %d", state);
+  SIM_CHECK(memcmp(&pid, &before, sizeof(pid)) == 0,
+            "failed tune modified the pid");
+
+  // 完成的整定: 系数更新，历史清零，限幅与变化率设置保留
+  SimRelay(p, &tune);
+  state = PIDAutoTune_Apply(&tune, PID_TUNE_ZieglerNichols, &pid);
+  SIM_CHECK(state == PID_TUNE_Done, "done tune returned %d", state);
+  SIM_CHECK(pid.core.kp != before.core.kp, "gains not written");
+  SIM_CHECK(pid.core.integral == 0.0f && pid.core.prev_error == 0.0f &&
+                pid.core.d_filtered == 0.0f && pid.core.prev_d_in == 0.0f &&
+                pid.core.d_primed == 0 && pid.core.prev_out == 0.0f &&
+                pid.out == 0.0f,
+            "history not cleared");
+  SIM_CHECK(pid.core.slew_rate == before.core.slew_rate &&
+                pid.core.out_max == before.core.out_max,
+            "limits not kept");
+  printf("apply: running/failed tune leave the pid unchanged\n");
+}
+
+int main(void) {
+  PIDAutoTuneType tune;
+  float ku, tu, kuRatio, tuErr, time;
+  uint8_t i, j;
+
+  SimSeed(10);
+  SimApplyGuard();
+  for (i = 0; i < sizeof(simPlants) / sizeof(simPlants[0]); i++) {
+    const SimPlant *p = &simPlants[i];
+
+    SimUltimate(p, &ku, &tu);
+    time = SimRelay(p, &tune);
+    printf("%s\n  relay %s after %.1f s: ku %.3f (exact %.3f)  "
+           "tu %.3f s (exact %.3f)\n",
+           p->name, (tune.state == PID_TUNE_Done) ? "done" : "FAILED", time,
+           tune.ku, ku, tune.tu, tu);
+    SIM_CHECK(tune.state == PID_TUNE_Done, "%s relay failed", p->name);
+    if (tune.state != PID_TUNE_Done) {
+      continue;
+    }
+
+    kuRatio = tune.ku / ku;
+    tuErr = fabsf(tune.tu - tu) / tu;
+    SIM_CHECK(kuRatio > SIM_KU_RATIO_MIN && kuRatio < SIM_KU_RATIO_MAX,
+              "%s ku %.3f of exact", p->name, kuRatio);
+    SIM_CHECK(tuErr < SIM_TU_ERROR_MAX, "%s tu error %.1f %%", p->name,
+              100.0f * tuErr);
+
+    for (j = 0; j < sizeof(simRules) / sizeof(simRules[0]); j++) {
+      SimStep(p, &tune, &simRules[j]);
+    }
+  }
+
+  return simFailures != 0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file sim_closed_loop.c
+ * @brief 闭环仿真: PID驱动直流电机与FOPDT对象、mahony跟踪刚体转动，
+ *        输出阶跃响应指标、姿态误差与单次更新耗时
+ * @note 指标超出阈值时返回非0，作为PIDUpdate/MahonyUpdateAHRS改动的回归测试；
+ *       耗时只打印不检查
+ */
+#include "mahony.h"
+#include "pid.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_RATE_HZ 1000.0f
+#define SIM_DT (1.0f / SIM_RATE_HZ)
+
+/*阶跃响应记录长度上限*/
+#define SIM_STEP_MAX 20000
+
+static float simTrace[SIM_STEP_MAX]; // 阶跃响应记录
+
+/**
+ * @brief 直流电机速度环，PIDUpdate输出电枢电压
+ */
+static void SimMotorSpeedLoop(void) {
+  PlantDCMotorType motor;
+  PIDControllerType pid;
+  SimStepInfo info;
+  const float target = 300.0f; // rad/s
+  const uint32_t n = (uint32_t)(0.5f * SIM_RATE_HZ);
+  uint32_t k;
+
+  PlantDCMotor_Init(&motor, 2e-5f, 1e-5f, 0.02f, 1.2f, 1e-3f);
+  PID_Init(&pid, 0.04f, 1.0f, 0.0f, 12.0f);
+
+  for (k = 0; k < n; k++) {
+    PIDUpdate(&pid, target - motor.speed, SIM_DT);
+    simTrace[k] = PlantDCMotorStep(&motor, pid.out, SIM_DT);
+  }
+
+  SimStepMetrics(simTrace, n, SIM_DT, 0.0f, target, &info);
+  SimPrintStep("dc motor speed, PIDUpdate", &info);
+  SIM_CHECK(info.riseTime > 0.0f && info.riseTime < 0.06f, "rise %.4f s",
+            info.riseTime);
+  SIM_CHECK(info.overshoot < 6.0f, "overshoot %.2f %%", info.overshoot);
+  SIM_CHECK(info.settlingTime < 0.2f, "settling %.4f s", info.settlingTime);
+  SIM_CHECK(info.steadyError < 0.5f, "steady error %.3f %%", info.steadyError);
+}
+
+/**
+ * @brief 直流电机位置环，PIDUpdateSP测量值微分避免设定值阶跃引起的微分冲击
+ */
+static void SimMotorPositionLoop(void) {
+  PlantDCMotorType motor;
+  PIDControllerType pid;
+  SimStepInfo info;
+  const float target = 6.2831853f; // rad
+  const uint32_t n = (uint32_t)(1.0f * SIM_RATE_HZ);
+  uint32_t k;
+
+  PlantDCMotor_Init(&motor, 2e-5f, 1e-5f, 0.02f, 1.2f, 1e-3f);
+  PID_Init(&pid, 8.0f, 0.0f, 0.25f, 12.0f);
+  PID_SetDerivativeFilter(&pid, 100.0f);
+
+  for (k = 0; k < n; k++) {
+    PIDUpdateSP(&pid, target, motor.angle, SIM_DT);
+    PlantDCMotorStep(&motor, pid.out, SIM_DT);
+    simTrace[k] = motor.angle;
+  }
+
+  SimStepMetrics(simTrace, n, SIM_DT, 0.0f, target, &info);
+  SimPrintStep("dc motor angle, PIDUpdateSP", &info);
+  SIM_CHECK(info.riseTime > 0.0f && info.riseTime < 0.1f, "rise %.4f s",
+            info.riseTime);
+  SIM_CHECK(info.overshoot < 2.0f, "overshoot %.2f %%", info.overshoot);
+  SIM_CHECK(info.settlingTime < 0.2f, "settling %.4f s", info.settlingTime);
+  SIM_CHECK(info.steadyError < 1.0f, "steady error %.3f %%", info.steadyError);
+}
+
+/**
+ * @brief FOPDT对象(如加热器)的PI控制，条件积分抗饱和
+ */
+static void SimFOPDTLoop(void) {
+  PlantFOPDTType plant;
+  PIDControllerType pid;
+  SimStepInfo info;
+  const float target = 50.0f;
+  const uint32_t n = (uint32_t)(20.0f * SIM_RATE_HZ);
+  uint32_t k;
+
+  // 增益2，时间常数2 s，纯滞后0.3 s，控制量0~100
+  PlantFOPDT_Init(&plant, 2.0f, 2.0f, 0.3f, SIM_DT);
+  PID_Init(&pid, 1.2f, 0.6f, 0.0f, 100.0f);
+  PID_SetOutputLimits(&pid, 0.0f, 100.0f);
+  PID_SetAntiWindup(&pid, PID_AW_Conditional, 0.0f);
+
+  for (k = 0; k < n; k++) {
+    PIDUpdate(&pid, target - plant.y, SIM_DT);
+    simTrace[k] = PlantFOPDTStep(&plant, pid.out, SIM_DT);
+  }
+
+  SimStepMetrics(simTrace, n, SIM_DT, 0.0f, target, &info);
+  SimPrintStep("fopdt, PIDUpdate", &info);
+  SIM_CHECK(info.riseTime > 0.0f && info.riseTime < 1.5f, "rise %.4f s",
+            info.riseTime);
+  SIM_CHECK(info.overshoot < 3.0f, "overshoot %.2f %%", info.overshoot);
+  SIM_CHECK(info.settlingTime < 3.0f, "settling %.4f s", info.settlingTime);
+  SIM_CHECK(info.steadyError < 0.5f, "steady error %.3f %%", info.steadyError);
+}
+
+/**
+ * @brief 测试用角速度曲线，三轴不同频率的正弦
+ *
+ * @param t 时间(s)
+ * @param w 输出载体系角速度(rad/s)
+ */
+static void SimAngularRate(float t, float w[3]) {
+  w[0] = 0.8f * sinf(6.2831853f * 0.20f * t);
+  w[1] = 0.6f * sinf(6.2831853f * 0.13f * t + 1.0f);
+  w[2] = 0.5f * cosf(6.2831853f * 0.07f * t);
+}
+
+/**
+ * @brief mahony跟踪刚体转动，含陀螺仪零偏与噪声，从30°初始误差开始
+ *
+ * @param useMag 1为MahonyUpdateAHRS(九轴)，0为MahonyUpdateAHRSIMU(六轴)
+ * @param rmsLimit 收敛后均方根误差上限(°)
+ * @param maxLimit 收敛后最大误差上限(°)
+ */
+static void SimAttitude(uint8_t useMag, float rmsLimit, float maxLimit) {
+  PlantRigidBodyType body;
+  MahonyFilterType ahrs;
+  MahonyInput imu;
+  const uint32_t n = (uint32_t)(60.0f * SIM_RATE_HZ);
+  const uint32_t settle = (uint32_t)(10.0f * SIM_RATE_HZ);
+  float w[3], qEst[4];
+  double sumSq = 0.0;
+  float maxErr = 0.0f, errDeg, err;
+  uint32_t k;
+
+  SimSeed(1);
+  PlantRigidBody_Init(&body);
+  body.gyroBias[0] = 0.01f;
+  body.gyroBias[1] = -0.02f;
+  body.gyroBias[2] = 0.005f;
+  // 初始横滚30°
+  body.q[0] = cosf(0.2617994f);
+  body.q[1] = sinf(0.2617994f);
+
+  MahonyFilterCoreInit(&ahrs);
+
+  for (k = 0; k < n; k++) {
+    SimAngularRate((float)k * SIM_DT, w);
+    PlantRigidBodyStep(&body, w, SIM_DT);
+    PlantRigidBodyIMU(&body, w, &imu);
+
+    if (useMag) {
+      // MahonyUpdateAHRS要求°/s
+      imu.gyro.x *= 57.29578f;
+      imu.gyro.y *= 57.29578f;
+      imu.gyro.z *= 57.29578f;
+      MahonyUpdateAHRS(&ahrs, &imu, SIM_DT);
+    } else {
+      MahonyUpdateAHRSIMU(&ahrs, &imu, SIM_DT);
+    }
+
+    if (k < settle) {
+      continue;
+    }
+    MahonyGetQuaternion(&ahrs, qEst);
+    // 六轴无航向参考，只比较倾斜
+    err = useMag ? SimQuatAngle(body.q, qEst) : SimTiltAngle(body.q, qEst);
+    errDeg = err * 57.29578f;
+    sumSq += (double)errDeg * errDeg;
+    if (errDeg > maxErr) {
+      maxErr = errDeg;
+    }
+  }
+
+  err = (float)sqrt(sumSq / (double)(n - settle));
+  printf("%-28s rms %6.3f deg  max %6.3f deg\n",
+         useMag ? "mahony MARG attitude" : "mahony IMU tilt", err, maxErr);
+  SIM_CHECK(err < rmsLimit, "rms attitude error %.3f deg", err);
+  SIM_CHECK(maxErr < maxLimit, "max attitude error %.3f deg", maxErr);
+}
+
+/*性能测试输入组数，循环取用，避免固定输入被分支预测与缓存美化*/
+#define SIM_BENCH_INPUTS 1024
+#define SIM_BENCH_CALLS 2000000u
+
+/**
+ * @brief 单次更新耗时
+ */
+static void SimBenchmark(void) {
+  static MahonyInput inputs[SIM_BENCH_INPUTS];    // 陀螺仪rad/s
+  static MahonyInput inputsDeg[SIM_BENCH_INPUTS]; // 陀螺仪°/s
+  static float errors[SIM_BENCH_INPUTS];
+  PlantRigidBodyType body;
+  PIDControllerType pid;
+  MahonyFilterType ahrs;
+  MahonyInput imu;
+  float w[3];
+  uint64_t t0;
+  uint32_t k;
+
+  SimSeed(2);
+  PlantRigidBody_Init(&body);
+  for (k = 0; k < SIM_BENCH_INPUTS; k++) {
+    SimAngularRate((float)k * SIM_DT, w);
+    PlantRigidBodyStep(&body, w, SIM_DT);
+    PlantRigidBodyIMU(&body, w, &inputs[k]);
+    inputsDeg[k] = inputs[k];
+    inputsDeg[k].gyro.x *= 57.29578f;
+    inputsDeg[k].gyro.y *= 57.29578f;
+    inputsDeg[k].gyro.z *= 57.29578f;
+    errors[k] = 10.0f * SimRandn();
+  }
+
+  PID_Init(&pid, 1.0f, 10.0f, 0.01f, 100.0f);
+  t0 = SimNowNs();
+  for (k = 0; k < SIM_BENCH_CALLS; k++) {
+    PIDUpdate(&pid, errors[k & (SIM_BENCH_INPUTS - 1)], SIM_DT);
+  }
+  SIM_KEEP(pid.out);
+  printf("%-28s %7.2f ns/update\n", "PIDUpdate",
+         (double)(SimNowNs() - t0) / SIM_BENCH_CALLS);
+
+  PID_Init(&pid, 1.0f, 10.0f, 0.01f, 100.0f);
+  PID_SetDerivativeFilter(&pid, 100.0f);
+  t0 = SimNowNs();
+  for (k = 0; k < SIM_BENCH_CALLS; k++) {
+    PIDUpdateSP(&pid, 1.0f, errors[k & (SIM_BENCH_INPUTS - 1)], SIM_DT);
+  }
+  SIM_KEEP(pid.out);
+  printf("%-28s %7.2f ns/update\n", "PIDUpdateSP",
+         (double)(SimNowNs() - t0) / SIM_BENCH_CALLS);
+
+  // 接口会就地修改输入，每次调用前从输入表拷贝
+  MahonyFilterCoreInit(&ahrs);
+  t0 = SimNowNs();
+  for (k = 0; k < SIM_BENCH_CALLS; k++) {
+    imu = inputs[k & (SIM_BENCH_INPUTS - 1)];
+    MahonyUpdateAHRSIMU(&ahrs, &imu, SIM_DT);
+  }
+  SIM_KEEP(ahrs.filter.q[0]);
+  printf("%-28s %7.2f ns/update\n", "MahonyUpdateAHRSIMU",
+         (double)(SimNowNs() - t0) / SIM_BENCH_CALLS);
+
+  MahonyFilterCoreInit(&ahrs);
+  t0 = SimNowNs();
+  for (k = 0; k < SIM_BENCH_CALLS; k++) {
+    imu = inputsDeg[k & (SIM_BENCH_INPUTS - 1)];
+    MahonyUpdateAHRS(&ahrs, &imu, SIM_DT);
+  }
+  SIM_KEEP(ahrs.filter.q[0]);
+  printf("%-28s %7.2f ns/update\n", "MahonyUpdateAHRS",
+         (double)(SimNowNs() - t0) / SIM_BENCH_CALLS);
+}
+
+int main(void) {
+  SimMotorSpeedLoop();
+  SimMotorPositionLoop();
+  SimFOPDTLoop();
+  SimAttitude(1, 1.5f, 3.0f);
+  SimAttitude(0, 0.3f, 0.6f);
+  SimBenchmark();
+
+  return simFailures != 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file sim_integrator.c
+ * @brief mahony四元数积分在100 Hz~8 kHz下的精度、耗时与闭环结果
+ * @note 每种MAHONY_INTEGRATOR单独编译一个程序(sim_integrator_euler等)；
+ *       纯积分误差超出该积分器的上限、或闭环零偏估计随采样率变化时返回非0；
+ *       耗时为逐次计时，含一次SimNowNs的开销
+ */
+#include "mahony.h"
+#include "plant.h"
+#include "sim.h"
+#include <math.h>
+
+#if (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_EULER)
+#define SIM_INTEGRATOR_NAME "euler"
+#define SIM_PROPAGATE_MAX 0.4f // 100 Hz下10 s纯积分误差上限(°)
+#elif (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_RK2)
+#define SIM_INTEGRATOR_NAME "rk2"
+#define SIM_PROPAGATE_MAX 0.2f
+#elif (MAHONY_INTEGRATOR == MAHONY_INTEGRATOR_EXP)
+#define SIM_INTEGRATOR_NAME "exp"
+#define SIM_PROPAGATE_MAX 0.01f // 只剩单精度舍入
+#endif
+
+/*纯积分时长与闭环时长(s)*/
+#define SIM_PROPAGATE_TIME 10.0f
+#define SIM_LOOP_TIME 60.0f
+
+static const float simRates[] = {100.0f,  200.0f,  500.0f, 1000.0f,
+                                 2000.0f, 4000.0f, 8000.0f};
+#define SIM_RATE_COUNT (sizeof(simRates) / sizeof(simRates[0]))
+
+/**
+ * @brief 恒定大角速度下的纯积分误差，参考为双精度指数映射
+ *
+ * @param rate 采样率(Hz)
+ * @param ns 输出，单次MahonyPropagate耗时(ns)
+ * @return float 终点姿态误差(°)
+ */
+static float SimPropagate(float rate, double *ns) {
+  const float w[3] = {3.0f, -2.0f, 1.0f}; // 约3.7 rad/s
+  const float dt = 1.0f / rate;
+  const uint32_t steps = (uint32_t)lroundf(SIM_PROPAGATE_TIME * rate);
+  MahonyFilterType ahrs;
+  float truth[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+  float q[4];
+  uint64_t t0, elapsed = 0;
+  uint32_t k;
+
+  MahonyFilterCoreInit(&ahrs);
+  for (k = 0; k < steps; k++) {
+    t0 = SimNowNs();
+    MahonyPropagate(&ahrs, w[0], w[1], w[2], dt);
+    elapsed += SimNowNs() - t0;
+    PlantQuatIntegrate(truth, w, dt);
+  }
+
+  *ns = (double)elapsed / steps;
+  MahonyGetQuaternion(&ahrs, q);
+  return SimQuatAngle(truth, q) * 57.29578f;
+}
+
+/**
+ * @brief 六轴闭环: 刚体仿真、陀螺仪带零偏，按给定采样率运行MahonyUpdateAHRSIMU
+ *
+ * @param rate 采样率(Hz)
+ * @param tilt 输出，后半程倾角误差均方根(°)
+ * @param ns 输出，单次更新耗时(ns)
+ * @return float 终点零偏估计误差(rad/s)
+ */
+static float SimLoop(float rate, float *tilt, double *ns) {
+  const float bias[3] = {0.02f, -0.03f, 0.01f};
+  const float dt = 1.0f / rate;
+  const uint32_t steps = (uint32_t)lroundf(SIM_LOOP_TIME * rate);
+  PlantRigidBodyType body;
+  MahonyFilterType ahrs;
+  MahonyInput imu;
+  float w[3], q[4], err, biasErr = 0.0f;
+  double sum = 0.0;
+  uint64_t t0, elapsed = 0;
+  uint32_t k, used = 0;
+  uint8_t i;
+
+  SimSeed(7);
+  PlantRigidBody_Init(&body);
+  for (i = 0; i < 3; i++) {
+    body.gyroBias[i] = bias[i];
+  }
+  MahonyFilterCoreInit(&ahrs);
+  // 加大Ki使零偏在SIM_LOOP_TIME内收敛，时间常数约Kp/Ki
+  MahonySetGains(&ahrs, 2.0f, 0.5f);
+
+  for (k = 0; k < steps; k++) {
+    float t = (float)k * dt;
+
+    w[0] = 1.5f * sinf(6.2831853f * 0.5f * t);
+    w[1] = 1.0f * sinf(6.2831853f * 0.3f * t + 1.0f);
+    w[2] = 0.8f * cosf(6.2831853f * 0.2f * t);
+    PlantRigidBodyStep(&body, w, dt);
+    PlantRigidBodyIMU(&body, w, &imu);
+
+    t0 = SimNowNs();
+    MahonyUpdateAHRSIMU(&ahrs, &imu, dt);
+    elapsed += SimNowNs() - t0;
+
+    if (t >= 0.5f * SIM_LOOP_TIME) {
+      MahonyGetQuaternion(&ahrs, q);
+      err = SimTiltAngle(body.q, q) * 57.29578f;
+      sum += (double)err * err;
+      used++;
+    }
+  }
+
+  // 积分项与零偏反号；航向零偏六轴下不可观，只看x、y
+  for (i = 0; i < 2; i++) {
+    err = fabsf(-ahrs.filter.integralFB[i] - bias[i]);
+    biasErr = (err > biasErr) ? err : biasErr;
+  }
+  *tilt = (float)sqrt(sum / used);
+  *ns = (double)elapsed / steps;
+  return biasErr;
+}
+
+int main(void) {
+  float prop[SIM_RATE_COUNT], bias[SIM_RATE_COUNT], tilt[SIM_RATE_COUNT];
+  double nsProp, nsLoop;
+  uint32_t r;
+
+  printf("integrator %s\n", SIM_INTEGRATOR_NAME);
+  printf("%8s %12s %10s %12s %12s %10s\n", "rate[Hz]", "prop[deg]",
+         "prop[ns]", "bias[rad/s]", "tilt[deg]", "loop[ns]");
+  for (r = 0; r < SIM_RATE_COUNT; r++) {
+    prop[r] = SimPropagate(simRates[r], &nsProp);
+    bias[r] = SimLoop(simRates[r], &tilt[r], &nsLoop);
+    printf("%8.0f %12.5f %10.1f %12.5f %12.4f %10.1f\n", simRates[r], prop[r],
+           nsProp, bias[r], tilt[r], nsLoop);
+  }
+
+  // 精度: 最低采样率下不超过该积分器的上限，且随采样率升高不变差
+  SIM_CHECK(prop[0] < SIM_PROPAGATE_MAX, "100 Hz propagation error %.4f deg",
+            prop[0]);
+  SIM_CHECK(prop[SIM_RATE_COUNT - 1] <= prop[0] + 0.01f,
+            "8 kHz propagation error %.4f > 100 Hz %.4f",
+            prop[SIM_RATE_COUNT - 1], prop[0]);
+
+  // 采样率无关: 各采样率下零偏都收敛、倾角误差都有界
+  for (r = 0; r < SIM_RATE_COUNT; r++) {
+    SIM_CHECK(bias[r] < 0.005f, "%.0f Hz bias error %.5f rad/s", simRates[r],
+              bias[r]);
+    SIM_CHECK(tilt[r] < 1.0f, "%.0f Hz tilt error %.4f deg", simRates[r],
+              tilt[r]);
+  }
+  SIM_CHECK(bias[0] < 2.0f * bias[SIM_RATE_COUNT - 1],
+            "bias error %.5f at 100 Hz vs %.5f at 8 kHz", bias[0],
+            bias[SIM_RATE_COUNT - 1]);
+
+  return simFailures != 0;
+}
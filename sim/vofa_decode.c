@@ -0,0 +1,337 @@
+/**
+ * @file vofa_decode.c
+ * @brief 上位机工具: 将VOFATxCompact发出的压缩帧流转为justfloat，供VOFA+显示
+ * @note 用法:
+ *       vofa_decode -n 通道数 [-c 通道=f16|s缩放] [-i 输入] [-o 输出]
+ *       通道配置须与下位机VOFA_CompactSetChannel一致，如"-c 0=s100"表示
+ *       通道0为VOFA_Q_Scaled16、scale为100，通道号可写"*"表示全部；
+ *       默认从stdin读、向stdout写，统计信息输出到stderr。
+ *       vofa_decode --selftest 编码带误码与丢字节的数据流，检查解码结果
+ */
+#include "sim.h"
+#include "vofa.h"
+#include "vofa_compact.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*接收缓冲，不小于最长的一帧*/
+#define DECODE_BUF_SIZE 512u
+
+/*流解码器: 在字节流中查找帧头、按长度截取整帧并解码*/
+typedef struct {
+  VOFACompactType codec;
+  uint8_t buf[DECODE_BUF_SIZE];
+  uint32_t len;       // 缓冲中的字节数
+  uint32_t frames;    // 解码成功的帧数
+  uint32_t errors;    // 格式或校验和错误
+  uint32_t waits;     // 丢帧后等待关键帧而丢弃的差分帧
+  uint32_t skipped;   // 查找帧头时丢弃的字节
+  float out[VOFA_COMPACT_MAX];
+} DecodeStream;
+
+/*每解码出一帧调用一次*/
+typedef void (*DecodeSink)(const DecodeStream *stream, void *user);
+
+/**
+ * @brief 处理缓冲中所有完整的帧
+ *
+ * @param s 流解码器
+ * @param sink 输出回调
+ * @param user 回调参数
+ * @note 校验失败时只丢弃帧头一个字节再重新查找，避免漏掉紧随其后的真帧
+ */
+static void DecodeProcess(DecodeStream *s, DecodeSink sink, void *user) {
+  const uint32_t frameMax = VOFA_COMPACT_FRAME_MAX(s->codec.count);
+  uint32_t pos = 0, total;
+  VOFAErrorType status;
+
+  while (pos < s->len) {
+    if (s->buf[pos] != VOFA_COMPACT_HEAD) {
+      pos++;
+      s->skipped++;
+      continue;
+    }
+    if (s->len - pos < 2) {
+      break;
+    }
+    total = (uint32_t)s->buf[pos + 1] + 4;
+    if (total > frameMax) {
+      // 长度不可能出现，不是帧头
+      pos++;
+      s->skipped++;
+      continue;
+    }
+    if (s->len - pos < total) {
+      break;
+    }
+
+    status = VOFACompactDecode(&s->codec, &s->buf[pos], (uint8_t)total,
+                               s->out);
+    if (status == vofa_DataError) {
+      s->errors++;
+      pos++;
+      continue;
+    }
+    if (status == vofa_Ok) {
+      s->frames++;
+      sink(s, user);
+    } else {
+      s->waits++;
+    }
+    pos += total;
+  }
+
+  memmove(s->buf, &s->buf[pos], s->len - pos);
+  s->len -= pos;
+}
+
+/**
+ * @brief 送入一段字节流
+ *
+ * @param s 流解码器
+ * @param data 数据
+ * @param n 字节数
+ * @param sink 输出回调
+ * @param user 回调参数
+ */
+static void DecodeFeed(DecodeStream *s, const uint8_t *data, uint32_t n,
+                       DecodeSink sink, void *user) {
+  uint32_t chunk;
+
+  while (n > 0) {
+    chunk = DECODE_BUF_SIZE - s->len;
+    chunk = (chunk < n) ? chunk : n;
+    memcpy(&s->buf[s->len], data, chunk);
+    s->len += chunk;
+    data += chunk;
+    n -= chunk;
+    DecodeProcess(s, sink, user);
+  }
+}
+
+/**
+ * @brief 以justfloat格式(小端float + 帧尾)写出一帧
+ */
+static void DecodeWriteJustFloat(const DecodeStream *s, void *user) {
+  FILE *fp = (FILE *)user;
+
+  fwrite(s->out, sizeof(float), s->codec.count, fp);
+  fwrite(VOFAJustFloatTail, 1, 4, fp);
+}
+
+/**
+ * @brief 解析"-c 通道=f16|s缩放"
+ *
+ * @param codec 解码器
+ * @param arg 参数文本
+ * @return int 0为成功
+ */
+static int DecodeParseChannel(VOFACompactType *codec, const char *arg) {
+  const char *eq = strchr(arg, '=');
+  int first, last, k;
+  VOFAQuantType quant;
+  float scale = 1.0f;
+
+  if (eq == NULL) {
+    return 1;
+  }
+  if (arg[0] == '*') {
+    first = 0;
+    last = VOFA_COMPACT_MAX - 1;
+  } else {
+    first = last = atoi(arg);
+    if (first < 0 || first >= VOFA_COMPACT_MAX) {
+      return 1;
+    }
+  }
+  if (strcmp(eq + 1, "f16") == 0) {
+    quant = VOFA_Q_Float16;
+  } else if (eq[1] == 's') {
+    quant = VOFA_Q_Scaled16;
+    scale = strtof(eq + 2, NULL);
+    if (scale == 0.0f) {
+      return 1;
+    }
+  } else {
+    return 1;
+  }
+
+  for (k = first; k <= last; k++) {
+    VOFA_CompactSetChannel(codec, (uint8_t)k, quant, scale);
+  }
+  return 0;
+}
+
+/*自检: 记录解码输出供比较*/
+typedef struct {
+  float (*frames)[VOFA_COMPACT_MAX]; // 解码出的各帧
+  uint32_t count;
+  uint32_t capacity;
+} DecodeCapture;
+
+static void DecodeCaptureFrame(const DecodeStream *s, void *user) {
+  DecodeCapture *cap = (DecodeCapture *)user;
+
+  if (cap->count < cap->capacity) {
+    memcpy(cap->frames[cap->count], s->out, sizeof(float) * s->codec.count);
+  }
+  cap->count++;
+}
+
+/**
+ * @brief 编码已知信号，注入误码与丢字节，经流解码器还原并逐帧核对
+ *
+ * @return int 失败数
+ */
+static int DecodeSelfTest(void) {
+  enum { CH = 12, FRAMES = 20000, KEY = 16 };
+  static uint8_t stream[FRAMES * VOFA_COMPACT_FRAME_MAX(CH)];
+  static float sent[FRAMES][CH];
+  static float recv[FRAMES][VOFA_COMPACT_MAX];
+  VOFACompactType enc;
+  DecodeStream dec;
+  DecodeCapture cap = {recv, 0, FRAMES};
+  uint32_t len = 0, k, corrupt = 0, dropped = 0, maxGap = 0, last = 0;
+  float tol, err, worst = 0.0f;
+  uint64_t t0, ns;
+  uint8_t frame[VOFA_COMPACT_FRAME_MAX(CH)];
+  uint8_t n, c;
+
+  VOFA_CompactInit(&enc, CH, KEY);
+  memset(&dec, 0, sizeof(dec));
+  VOFA_CompactInit(&dec.codec, CH, KEY);
+  for (c = 0; c < CH; c++) {
+    if (c % 3 == 0) {
+      VOFA_CompactSetChannel(&enc, c, VOFA_Q_Scaled16, 100.0f);
+      VOFA_CompactSetChannel(&dec.codec, c, VOFA_Q_Scaled16, 100.0f);
+    }
+  }
+
+  // 慢变的正弦与噪声，约0.1%的帧注入单字节误码，约0.1%的帧丢失一个字节
+  SimSeed(12);
+  for (k = 0; k < FRAMES; k++) {
+    for (c = 0; c < CH; c++) {
+      sent[k][c] = 50.0f * sinf(0.001f * (float)k * (c + 1)) +
+                   0.05f * SimRandn();
+    }
+    n = VOFACompactEncode(&enc, sent[k], frame);
+    if (SimRandu() < 0.001f) {
+      frame[SimRandu() < 0.5f ? 1 : n - 2] ^= 0x10;
+      corrupt++;
+    }
+    if (SimRandu() < 0.001f) {
+      memmove(&frame[2], &frame[3], n - 3);
+      n--;
+      dropped++;
+    }
+    memcpy(&stream[len], frame, n);
+    len += n;
+  }
+
+  t0 = SimNowNs();
+  DecodeFeed(&dec, stream, len, DecodeCaptureFrame, &cap);
+  ns = SimNowNs() - t0;
+
+  // 解码帧按顺序与发送帧对齐: 向后找误差最小的一帧
+  for (k = 0; k < cap.count && k < FRAMES; k++) {
+    uint32_t j, best = last;
+    float bestErr = INFINITY;
+
+    for (j = last; j < FRAMES && j < last + 64; j++) {
+      err = 0.0f;
+      for (c = 0; c < CH; c++) {
+        err = fmaxf(err, fabsf(recv[k][c] - sent[j][c]));
+      }
+      if (err < bestErr) {
+        bestErr = err;
+        best = j;
+      }
+    }
+    maxGap = (best - last > maxGap) ? best - last : maxGap;
+    last = best + 1;
+
+    for (c = 0; c < CH; c++) {
+      // float16相对误差2^-11，scaled16为半个1/scale
+      tol = (c % 3 == 0) ? 0.0051f : fabsf(sent[best][c]) * 4.9e-4f + 1e-6f;
+      err = fabsf(recv[k][c] - sent[best][c]) / tol;
+      worst = (err > worst) ? err : worst;
+    }
+  }
+
+  fprintf(stderr,
+          "selftest: %u frames, %u corrupted, %u lost a byte -> decoded %u, "
+          "errors %u, waiting %u, skipped %u bytes\n",
+          FRAMES, corrupt, dropped, dec.frames, dec.errors, dec.waits,
+          dec.skipped);
+  fprintf(stderr,
+          "selftest: worst quantization error %.2f of tolerance, longest "
+          "gap %u frames, decode %.1f MB/s (%.0f ns/frame)\n",
+          worst, maxGap, (double)len * 1e3 / (double)ns,
+          (double)ns / dec.frames);
+
+  SIM_CHECK(worst <= 1.0f, "quantization error %.2f of tolerance", worst);
+  // 每次损坏最多丢到下一个关键帧
+  SIM_CHECK(maxGap <= 2 * KEY, "gap of %u frames", maxGap);
+  SIM_CHECK(dec.frames + 2 * KEY * (corrupt + dropped) >= FRAMES,
+            "only %u of %u frames decoded", dec.frames, FRAMES);
+  SIM_CHECK(dec.frames < FRAMES, "corruption went undetected");
+  return simFailures;
+}
+
+static void DecodeUsage(void) {
+  fprintf(stderr,
+          "usage: vofa_decode -n count [-c ch=f16|ch=sSCALE]... "
+          "[-i input] [-o output]\n"
+          "       vofa_decode --selftest\n");
+}
+
+int main(int argc, char **argv) {
+  static DecodeStream s;
+  FILE *in = stdin, *out = stdout;
+  uint8_t chunk[4096];
+  size_t n;
+  int k, count = 0;
+
+  if (argc == 2 && strcmp(argv[1], "--selftest") == 0) {
+    return DecodeSelfTest() != 0;
+  }
+
+  VOFA_CompactInit(&s.codec, VOFA_COMPACT_MAX, 1);
+  for (k = 1; k < argc; k++) {
+    if (strcmp(argv[k], "-n") == 0 && k + 1 < argc) {
+      count = atoi(argv[++k]);
+    } else if (strcmp(argv[k], "-c") == 0 && k + 1 < argc) {
+      if (DecodeParseChannel(&s.codec, argv[++k]) != 0) {
+        fprintf(stderr, "bad channel spec: %s\n", argv[k]);
+        return 1;
+      }
+    } else if (strcmp(argv[k], "-i") == 0 && k + 1 < argc) {
+      in = fopen(argv[++k], "rb");
+    } else if (strcmp(argv[k], "-o") == 0 && k + 1 < argc) {
+      out = fopen(argv[++k], "wb");
+    } else {
+      DecodeUsage();
+      return 1;
+    }
+    if (in == NULL || out == NULL) {
+      fprintf(stderr, "cannot open %s\n", argv[k]);
+      return 1;
+    }
+  }
+  if (count <= 0 || count > VOFA_COMPACT_MAX) {
+    DecodeUsage();
+    return 1;
+  }
+  // 通道配置保留，只改通道数
+  s.codec.count = (uint8_t)count;
+
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    DecodeFeed(&s, chunk, (uint32_t)n, DecodeWriteJustFloat, out);
+  }
+  fflush(out);
+  fprintf(stderr, "decoded %u frames, %u errors, %u waiting for keyframe, "
+                  "%u bytes skipped\n",
+          s.frames, s.errors, s.waits, s.skipped);
+  return 0;
+}